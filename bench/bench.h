@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    //! One measurement, reported as a single line of CSV
+    struct result
+    {
+        std::string benchmark;
+        std::string resource;
+        std::string sizes; // the request size distribution
+        std::size_t threads;
+        std::uint64_t ops;
+        double seconds;
+        double p50_ns; // latency percentiles of one op; 0 if not sampled
+        double p99_ns;
+    };
+
+    //! Writes r to stdout
+    void report(const result& r);
+
+    using benchmark_fn = void (*)();
+
+    //! Registers a benchmark with the driver in main.cpp
+    struct registrar
+    {
+        registrar(const char* name, benchmark_fn fn);
+    };
+
+    //! Runs fn(thread_index) on nthreads threads released at the same time
+    //!
+    //! \return the wall clock seconds until the last thread finished
+    double run_threads(std::size_t nthreads,
+            const std::function<void(std::size_t)>& fn);
+
+    //! Powers of two up to std::thread::hardware_concurrency()
+    std::vector<std::size_t> thread_counts();
+
+    //! A repeating sequence of request sizes drawn from one distribution
+    struct size_sequence
+    {
+        std::string name;
+        std::vector<std::size_t> sizes;
+    };
+
+    //! Sequences for fixed 64 byte requests, sizes uniform in [16, 1024],
+    //! log-normal sizes with a median around 64 bytes and, if the
+    //! PMR_BENCH_TRACE environment variable names a trace written by
+    //! pmr::recording_resource or a file of whitespace separated sizes,
+    //! the sizes recorded there
+    const std::vector<size_sequence>& size_distributions();
+
+    //! The pth percentile, p in [0, 1], of samples; reorders samples
+    double percentile(std::vector<double>& samples, double p);
+}
+
+#define PMR_BENCHMARK(name) \
+    static void name(); \
+    static ::bench::registrar name##_registrar{#name, name}; \
+    static void name()
@@ -0,0 +1,307 @@
+#include "bench.h"
+#include "pmr/deque.h"
+#include "pmr/list.h"
+#include "pmr/map.h"
+#include "pmr/memory_resource.h"
+#include "pmr/monotonic_buffer_resource.h"
+#include "pmr/string.h"
+#include "pmr/synchronized_pool_resource.h"
+#include "pmr/unordered_map.h"
+#include "pmr/unsynchronized_pool_resource.h"
+#include "pmr/vector.h"
+#include <chrono>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    const std::size_t mix_ops = 500000;
+    const std::size_t live_elements = 1024;
+    const std::size_t requests = 2000;
+    const std::size_t per_request = 256;
+
+    volatile std::size_t sink;
+
+
+    //! The standard containers with std::allocator
+    struct std_family
+    {
+        template <typename T> using vector = std::vector<T>;
+        template <typename T> using list = std::list<T>;
+        template <typename T> using deque = std::deque<T>;
+        template <typename K, typename V> using map = std::map<K, V>;
+        template <typename K, typename V>
+        using unordered_map = std::unordered_map<K, V>;
+        using string = std::string;
+
+        std::allocator<char> allocator() const
+        {
+            return {};
+        }
+
+        void end_request()
+        {
+        }
+    };
+
+
+    //! The pmr typedefs on one resource; a monotonic_buffer_resource is
+    //! released after every request
+    struct pmr_family
+    {
+        template <typename T> using vector = pmr::vector<T>;
+        template <typename T> using list = pmr::list<T>;
+        template <typename T> using deque = pmr::deque<T>;
+        template <typename K, typename V> using map = pmr::map<K, V>;
+        template <typename K, typename V>
+        using unordered_map = pmr::unordered_map<K, V>;
+        using string = pmr::string;
+
+        pmr::polymorphic_allocator<char> allocator() const
+        {
+            return {resource};
+        }
+
+        void end_request()
+        {
+            if(auto* mbr =
+                    dynamic_cast<pmr::monotonic_buffer_resource*>(resource))
+            {
+                mbr->release();
+            }
+        }
+
+        pmr::memory_resource* resource;
+    };
+
+
+    // sequences append at the back and drop from the front (or a random
+    // slot for vector) once they hold live_elements; maps look up a random
+    // key out of twice as many and erase it if found, insert it if not;
+    // strings of 8-256 chars are built, searched and destroyed
+    struct mix_vector
+    {
+        template <typename Family>
+        void operator()(Family& f, std::minstd_rand& rng) const
+        {
+            typename Family::template vector<int> v(f.allocator());
+            for(std::size_t i = 0; i < mix_ops; ++i)
+            {
+                if(v.size() < live_elements || rng() % 2)
+                {
+                    v.push_back(static_cast<int>(i));
+                }
+                else
+                {
+                    v[rng() % v.size()] = v.back();
+                    v.pop_back();
+                }
+                sink = sink + v[rng() % v.size()];
+            }
+        }
+    };
+
+
+    template <template <typename> class Sequence>
+    struct queue_mix
+    {
+        template <typename Family>
+        void operator()(Family& f, std::minstd_rand&) const
+        {
+            typename Sequence<Family>::type q(f.allocator());
+            for(std::size_t i = 0; i < mix_ops; ++i)
+            {
+                q.push_back(static_cast<int>(i));
+                if(q.size() > live_elements)
+                {
+                    q.pop_front();
+                }
+                sink = sink + q.front();
+            }
+        }
+    };
+
+    template <typename Family>
+    struct list_of { using type = typename Family::template list<int>; };
+
+    template <typename Family>
+    struct deque_of { using type = typename Family::template deque<int>; };
+
+
+    template <template <typename> class Map>
+    struct map_mix
+    {
+        template <typename Family>
+        void operator()(Family& f, std::minstd_rand& rng) const
+        {
+            typename Map<Family>::type m(f.allocator());
+            for(std::size_t i = 0; i < mix_ops; ++i)
+            {
+                int key = static_cast<int>(rng() % (2 * live_elements));
+                auto it = m.find(key);
+                if(it == m.end())
+                {
+                    m.emplace(key, key);
+                }
+                else
+                {
+                    sink = sink + it->second;
+                    m.erase(it);
+                }
+            }
+        }
+    };
+
+    template <typename Family>
+    struct map_of { using type = typename Family::template map<int, int>; };
+
+    template <typename Family>
+    struct unordered_map_of
+    {
+        using type = typename Family::template unordered_map<int, int>;
+    };
+
+
+    struct mix_string
+    {
+        template <typename Family>
+        void operator()(Family& f, std::minstd_rand& rng) const
+        {
+            for(std::size_t i = 0; i < mix_ops; ++i)
+            {
+                typename Family::string s(f.allocator());
+                s.append(8 + rng() % 249, 'a');
+                s.push_back('z');
+                sink = sink + s.find('z');
+            }
+        }
+    };
+
+
+    // the containers one request might build: an index, a lookup table, a
+    // hash table and a response body, all destroyed when it completes
+    struct build_and_destroy
+    {
+        template <typename Family>
+        void operator()(Family& f, std::minstd_rand& rng) const
+        {
+            for(std::size_t r = 0; r < requests; ++r)
+            {
+                {
+                    typename Family::template vector<int> v(f.allocator());
+                    typename Family::template map<int, int> m(f.allocator());
+                    typename Family::template unordered_map<int, int> u(
+                            f.allocator());
+                    typename Family::string s(f.allocator());
+                    for(std::size_t i = 0; i < per_request; ++i)
+                    {
+                        int key = static_cast<int>(rng());
+                        v.push_back(key);
+                        m.emplace(key, key);
+                        u.emplace(key, key);
+                        s.push_back(static_cast<char>('a' + key % 26));
+                    }
+                    sink = sink + v.size() + m.size() + u.size() + s.size();
+                }
+                f.end_request();
+            }
+        }
+    };
+
+
+    // a map of strings too long for the small string buffer; with the pmr
+    // typedefs polymorphic_allocator::construct hands the map's resource to
+    // every string so the whole structure lives in one resource
+    struct nested
+    {
+        template <typename Family>
+        void operator()(Family& f, std::minstd_rand& rng) const
+        {
+            const char* value = "a value that is long enough to be allocated";
+            for(std::size_t r = 0; r < requests; ++r)
+            {
+                {
+                    typename Family::template map<int,
+                             typename Family::string> m(f.allocator());
+                    for(std::size_t i = 0; i < per_request; ++i)
+                    {
+                        m.emplace(static_cast<int>(rng()), value);
+                    }
+                    sink = sink + m.begin()->second.size();
+                }
+                f.end_request();
+            }
+        }
+    };
+
+
+    template <typename Workload, typename Family>
+    void measure(const char* benchmark, const char* resource,
+            const char* sizes, std::size_t ops, Family& f)
+    {
+        std::minstd_rand rng(42);
+        auto start = std::chrono::steady_clock::now();
+        Workload{}(f, rng);
+        std::chrono::duration<double> secs =
+            std::chrono::steady_clock::now() - start;
+        bench::report({benchmark, resource, sizes, 1, ops, secs.count(), 0, 0});
+    }
+
+
+    //! Runs Workload with std::allocator and then with the pmr typedefs on
+    //! every resource
+    template <typename Workload>
+    void run(const char* benchmark, const char* sizes, std::size_t ops)
+    {
+        std_family std_containers;
+        measure<Workload>(benchmark, "std::allocator", sizes, ops,
+                std_containers);
+
+        pmr_family f{pmr::new_delete_resource()};
+        measure<Workload>(benchmark, "new_delete_resource", sizes, ops, f);
+
+        pmr::monotonic_buffer_resource mbr{pmr::new_delete_resource()};
+        f.resource = &mbr;
+        measure<Workload>(benchmark, "monotonic_buffer_resource", sizes, ops,
+                f);
+
+        pmr::unsynchronized_pool_resource upr{pmr::new_delete_resource()};
+        f.resource = &upr;
+        measure<Workload>(benchmark, "unsynchronized_pool_resource", sizes,
+                ops, f);
+
+        pmr::synchronized_pool_resource spr{pmr::new_delete_resource()};
+        f.resource = &spr;
+        measure<Workload>(benchmark, "synchronized_pool_resource", sizes, ops,
+                f);
+    }
+}
+
+
+PMR_BENCHMARK(container_mix)
+{
+    run<mix_vector>("mix_vector", "fixed", mix_ops);
+    run<queue_mix<list_of>>("mix_list", "fixed", mix_ops);
+    run<queue_mix<deque_of>>("mix_deque", "fixed", mix_ops);
+    run<map_mix<map_of>>("mix_map", "fixed", mix_ops);
+    run<map_mix<unordered_map_of>>("mix_unordered_map", "fixed", mix_ops);
+    run<mix_string>("mix_string", "uniform", mix_ops);
+}
+
+
+PMR_BENCHMARK(build_destroy)
+{
+    run<build_and_destroy>("build_destroy", "fixed", requests * per_request);
+}
+
+
+PMR_BENCHMARK(nested_containers)
+{
+    run<nested>("nested_containers", "fixed", requests * per_request);
+}
@@ -0,0 +1,59 @@
+#include "bench.h"
+#include "pmr/monotonic_buffer_resource.h"
+#include "pmr/polymorphic_allocator.h"
+#include "pmr/resource_allocator.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+    const std::size_t rounds = 20000;
+    const std::size_t allocs_per_round = 1000;
+
+
+    // one op is one 8 byte allocation; the resource is reset between
+    // rounds so that no round goes upstream after the first
+    template <typename Alloc>
+    void bump(const char* name, Alloc alloc, pmr::monotonic_buffer_resource& mbr)
+    {
+        using clock = std::chrono::steady_clock;
+
+        std::uintptr_t sink = 0;
+        clock::time_point start = clock::now();
+        for(std::size_t r = 0; r < rounds; ++r)
+        {
+            for(std::size_t i = 0; i < allocs_per_round; ++i)
+            {
+                sink ^= reinterpret_cast<std::uintptr_t>(alloc.allocate(2));
+            }
+            mbr.reset();
+        }
+        double secs = std::chrono::duration<double>(clock::now() - start).count();
+
+        // keeps the allocations observable
+        if(1 == sink)
+        {
+            std::printf("#\n");
+        }
+        bench::report({"monotonic_bump", name, "fixed", 1,
+                rounds * allocs_per_round, secs, 0, 0});
+    }
+}
+
+
+//! Compares the virtual path through polymorphic_allocator with the
+//! statically typed resource_allocator, whose bump should inline into the
+//! loop. Run it against the shared, static and header-only builds to see
+//! what each costs.
+PMR_BENCHMARK(monotonic_bump)
+{
+    pmr::monotonic_buffer_resource mbr{pmr::new_delete_resource()};
+
+    // hidden from the optimizer as it would be behind an interface
+    pmr::memory_resource* volatile opaque = &mbr;
+    bump("polymorphic_allocator", pmr::polymorphic_allocator<int>{opaque}, mbr);
+    bump("resource_allocator",
+            pmr::resource_allocator<int, pmr::monotonic_buffer_resource>{&mbr},
+            mbr);
+}
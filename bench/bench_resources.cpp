@@ -0,0 +1,245 @@
+#include "bench.h"
+#include "pmr/concurrent_monotonic_resource.h"
+#include "pmr/memory_resource.h"
+#include "pmr/monotonic_buffer_resource.h"
+#include "pmr/resource_adapter.h"
+#include "pmr/static_pool_resource.h"
+#include "pmr/statistics_resource.h"
+#include "pmr/synchronized_pool_resource.h"
+#include "pmr/thread_arena_resource.h"
+#include "pmr/unsynchronized_pool_resource.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    const std::size_t ops_per_thread = 1000000;
+    const std::size_t batch = 256;       // ops timed together as one sample
+    const std::size_t live_blocks = 256;
+
+    using steady = std::chrono::steady_clock;
+    using resource_ptr = std::shared_ptr<pmr::memory_resource>;
+
+
+    //! A resource under test and how to drive it
+    struct subject
+    {
+        const char* name;
+        resource_ptr (*make)();
+        bool thread_safe; // threads share one instance, else one each
+        bool reuses;      // deallocate makes memory available again
+    };
+
+
+    void reset(pmr::memory_resource& mr)
+    {
+        if(auto* mbr = dynamic_cast<pmr::monotonic_buffer_resource*>(&mr))
+        {
+            mbr->reset();
+        }
+    }
+
+
+    // size classes spaced like the pools of unsynchronized_pool_resource
+    // with a class between each pair of powers of two
+    using static_pools = pmr::static_pool_resource<16, 32, 48, 64, 96, 128,
+          192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096>;
+
+
+    const subject subjects[] = {
+        {"new_delete_resource", [] {
+            return resource_ptr{pmr::new_delete_resource(),
+                    [](pmr::memory_resource*) {}};
+        }, true, true},
+        {"resource_adapter", [] {
+            using adapter = pmr::resource_adapter<std::allocator<char>>;
+            return resource_ptr{std::make_shared<adapter>()};
+        }, true, true},
+        {"monotonic_buffer_resource", [] {
+            return resource_ptr{std::make_shared<pmr::monotonic_buffer_resource>(
+                    pmr::new_delete_resource())};
+        }, false, false},
+        {"concurrent_monotonic_resource", [] {
+            return resource_ptr{std::make_shared<pmr::concurrent_monotonic_resource>(
+                    pmr::new_delete_resource())};
+        }, true, false},
+        {"thread_arena_resource", [] {
+            return resource_ptr{std::make_shared<pmr::thread_arena_resource>(
+                    pmr::new_delete_resource())};
+        }, true, false},
+        {"unsynchronized_pool_resource", [] {
+            return resource_ptr{std::make_shared<pmr::unsynchronized_pool_resource>(
+                    pmr::new_delete_resource())};
+        }, false, true},
+        {"static_pool_resource", [] {
+            return resource_ptr{std::make_shared<static_pools>(
+                    pmr::new_delete_resource())};
+        }, false, true},
+        {"synchronized_pool_resource", [] {
+            return resource_ptr{std::make_shared<pmr::synchronized_pool_resource>(
+                    pmr::new_delete_resource())};
+        }, true, true},
+        // the counting overhead on top of new_delete_resource
+        {"statistics_resource", [] {
+            return resource_ptr{std::make_shared<pmr::statistics_resource>(
+                    pmr::new_delete_resource())};
+        }, true, true},
+    };
+
+
+    //! Collects per-op latency samples from every thread of a run
+    class samples
+    {
+      public:
+        void add(const std::vector<double>& thread_samples)
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_samples.insert(end(m_samples), begin(thread_samples),
+                    end(thread_samples));
+        }
+
+        double percentile(double p)
+        {
+            return bench::percentile(m_samples, p);
+        }
+
+      private:
+        std::mutex m_mutex;
+        std::vector<double> m_samples;
+    };
+
+
+    double ns_per_op(steady::time_point start, steady::time_point stop)
+    {
+        return std::chrono::duration<double, std::nano>(stop - start).count()
+            / batch;
+    }
+
+
+    // each op allocates a block and immediately frees it, the best case
+    // for every resource; monotonic_buffer_resource is reset between
+    // batches, outside the timed region
+    void alloc_free_loop(pmr::memory_resource& mr,
+            const bench::size_sequence& seq, std::size_t thread, samples& out)
+    {
+        const std::vector<std::size_t>& sizes = seq.sizes;
+        std::size_t next = thread * 7919 % sizes.size();
+        std::vector<double> latencies;
+        latencies.reserve(ops_per_thread / batch);
+        for(std::size_t n = 0; n < ops_per_thread; n += batch)
+        {
+            steady::time_point start = steady::now();
+            for(std::size_t i = 0; i < batch; ++i)
+            {
+                std::size_t size = sizes[next];
+                next = next + 1 == sizes.size() ? 0 : next + 1;
+                mr.deallocate(mr.allocate(size), size);
+            }
+            latencies.push_back(ns_per_op(start, steady::now()));
+            reset(mr);
+        }
+        out.add(latencies);
+    }
+
+
+    // each thread keeps a window of live blocks and replaces the oldest;
+    // one op is one deallocate plus one allocate
+    void churn_loop(pmr::memory_resource& mr, const bench::size_sequence& seq,
+            std::size_t thread, samples& out)
+    {
+        struct block
+        {
+            void* ptr;
+            std::size_t size;
+        };
+
+        const std::vector<std::size_t>& sizes = seq.sizes;
+        std::size_t next = thread * 7919 % sizes.size();
+        auto next_size = [&] {
+            std::size_t size = sizes[next];
+            next = next + 1 == sizes.size() ? 0 : next + 1;
+            return size;
+        };
+
+        std::vector<block> window(live_blocks);
+        for(block& b : window)
+        {
+            b.size = next_size();
+            b.ptr = mr.allocate(b.size);
+        }
+        std::vector<double> latencies;
+        latencies.reserve(ops_per_thread / batch);
+        std::size_t oldest = 0;
+        for(std::size_t n = 0; n < ops_per_thread; n += batch)
+        {
+            steady::time_point start = steady::now();
+            for(std::size_t i = 0; i < batch; ++i)
+            {
+                block& b = window[oldest];
+                oldest = oldest + 1 == live_blocks ? 0 : oldest + 1;
+                mr.deallocate(b.ptr, b.size);
+                b.size = next_size();
+                b.ptr = mr.allocate(b.size);
+            }
+            latencies.push_back(ns_per_op(start, steady::now()));
+        }
+        for(block& b : window)
+        {
+            mr.deallocate(b.ptr, b.size);
+        }
+        out.add(latencies);
+    }
+
+
+    using workload = void (*)(pmr::memory_resource&,
+            const bench::size_sequence&, std::size_t, samples&);
+
+
+    void run(const char* benchmark, workload fn, const subject& s)
+    {
+        for(const bench::size_sequence& seq : bench::size_distributions())
+        {
+            for(std::size_t threads : bench::thread_counts())
+            {
+                std::vector<resource_ptr> resources;
+                resources.push_back(s.make());
+                for(std::size_t i = 1; !s.thread_safe && i < threads; ++i)
+                {
+                    resources.push_back(s.make());
+                }
+
+                samples latencies;
+                double secs = bench::run_threads(threads, [&](std::size_t i) {
+                    fn(*resources[s.thread_safe ? 0 : i], seq, i, latencies);
+                });
+                bench::report({benchmark, s.name, seq.name, threads,
+                        threads * ops_per_thread, secs,
+                        latencies.percentile(0.5), latencies.percentile(0.99)});
+            }
+        }
+    }
+}
+
+
+PMR_BENCHMARK(alloc_free)
+{
+    for(const subject& s : subjects)
+    {
+        run("alloc_free", alloc_free_loop, s);
+    }
+}
+
+
+PMR_BENCHMARK(churn)
+{
+    for(const subject& s : subjects)
+    {
+        // without reuse the live window would grow without bound
+        if(s.reuses)
+        {
+            run("churn", churn_loop, s);
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include "bench.h"
+#include "pmr/memory_resource.h"
+#include "pmr/synchronized_pool_resource.h"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const std::size_t ops_per_thread = 2000000;
+    const std::size_t live_blocks = 256;
+
+    struct block
+    {
+        void* ptr;
+        std::size_t size;
+    };
+
+
+    // each thread keeps a window of live 16-256 byte blocks and repeatedly
+    // replaces a random one; one op is one deallocate plus one allocate
+    void churn(pmr::memory_resource& mr, std::size_t seed)
+    {
+        std::minstd_rand rng(seed);
+        std::uniform_int_distribution<std::size_t> sizes(16, 256);
+        std::vector<block> window(live_blocks);
+        for(block& b : window)
+        {
+            b.size = sizes(rng);
+            b.ptr = mr.allocate(b.size);
+        }
+        for(std::size_t i = 0; i < ops_per_thread; ++i)
+        {
+            block& b = window[rng() % live_blocks];
+            mr.deallocate(b.ptr, b.size);
+            b.size = sizes(rng);
+            b.ptr = mr.allocate(b.size);
+        }
+        for(block& b : window)
+        {
+            mr.deallocate(b.ptr, b.size);
+        }
+    }
+
+
+    // single producer, single consumer ring of messages
+    class channel
+    {
+      public:
+        void send(const block& b)
+        {
+            std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            while(tail - m_head.load(std::memory_order_acquire) == capacity)
+            {
+                std::this_thread::yield();
+            }
+            m_slots[tail % capacity] = b;
+            m_tail.store(tail + 1, std::memory_order_release);
+        }
+
+        block receive()
+        {
+            std::size_t head = m_head.load(std::memory_order_relaxed);
+            while(head == m_tail.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            block b = m_slots[head % capacity];
+            m_head.store(head + 1, std::memory_order_release);
+            return b;
+        }
+
+      private:
+        static const std::size_t capacity = 1024;
+        block m_slots[capacity];
+        alignas(64) std::atomic<std::size_t> m_head{0};
+        alignas(64) std::atomic<std::size_t> m_tail{0};
+    };
+
+
+    // even threads allocate 64-256 byte messages and send them to the next
+    // odd thread which frees them; one op is one allocate plus one free
+    void pipeline(const char* name, pmr::memory_resource& mr)
+    {
+        for(std::size_t threads : bench::thread_counts())
+        {
+            std::size_t pairs = std::max<std::size_t>(1, threads / 2);
+            std::vector<channel> channels(pairs);
+            double secs = bench::run_threads(pairs * 2, [&](std::size_t i) {
+                channel& ch = channels[i / 2];
+                if(i % 2)
+                {
+                    for(std::size_t n = 0; n < ops_per_thread; ++n)
+                    {
+                        block b = ch.receive();
+                        mr.deallocate(b.ptr, b.size);
+                    }
+                    return;
+                }
+                std::minstd_rand rng(i + 1);
+                std::uniform_int_distribution<std::size_t> sizes(64, 256);
+                for(std::size_t n = 0; n < ops_per_thread; ++n)
+                {
+                    std::size_t size = sizes(rng);
+                    ch.send(block{mr.allocate(size), size});
+                }
+            });
+            bench::report({"producer_consumer", name, "uniform", pairs * 2,
+                    pairs * ops_per_thread, secs, 0, 0});
+        }
+    }
+
+
+    void run(const char* name, pmr::memory_resource& mr)
+    {
+        for(std::size_t threads : bench::thread_counts())
+        {
+            double secs = bench::run_threads(threads,
+                    [&](std::size_t i) { churn(mr, i + 1); });
+            bench::report({"thread_scaling", name, "uniform", threads,
+                    threads * ops_per_thread, secs, 0, 0});
+        }
+    }
+}
+
+
+PMR_BENCHMARK(thread_scaling)
+{
+    run("new_delete_resource", *pmr::new_delete_resource());
+    pmr::synchronized_pool_resource spr{pmr::new_delete_resource()};
+    run("synchronized_pool_resource", spr);
+}
+
+
+PMR_BENCHMARK(producer_consumer)
+{
+    pipeline("new_delete_resource", *pmr::new_delete_resource());
+    pmr::synchronized_pool_resource spr{pmr::new_delete_resource()};
+    pipeline("synchronized_pool_resource", spr);
+}
@@ -0,0 +1,211 @@
+#include "bench.h"
+#include "pmr/recording_resource.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#ifndef PMR_BENCH_VERSION
+#   define PMR_BENCH_VERSION "unknown"
+#endif
+
+namespace bench
+{
+    namespace
+    {
+        std::vector<std::pair<std::string, benchmark_fn>>& registry()
+        {
+            static std::vector<std::pair<std::string, benchmark_fn>> benchmarks;
+            return benchmarks;
+        }
+    }
+
+
+    registrar::registrar(const char* name, benchmark_fn fn)
+    {
+        registry().emplace_back(name, fn);
+    }
+
+
+    void report(const result& r)
+    {
+        double ns_per_op = r.ops ? r.seconds * 1e9 / r.ops : 0.0;
+        double mops = r.seconds > 0 ? r.ops / r.seconds / 1e6 : 0.0;
+        std::printf("%s,%s,%s,%zu,%llu,%.6f,%.2f,%.2f,%.2f,%.2f,%s\n",
+                r.benchmark.c_str(), r.resource.c_str(), r.sizes.c_str(),
+                r.threads, static_cast<unsigned long long>(r.ops), r.seconds,
+                ns_per_op, mops, r.p50_ns, r.p99_ns, PMR_BENCH_VERSION);
+        std::fflush(stdout);
+    }
+
+
+    double run_threads(std::size_t nthreads,
+            const std::function<void(std::size_t)>& fn)
+    {
+        using clock = std::chrono::steady_clock;
+
+        std::atomic<std::size_t> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for(std::size_t i = 0; i < nthreads; ++i)
+        {
+            threads.emplace_back([&, i] {
+                ready.fetch_add(1);
+                while(!go.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                fn(i);
+            });
+        }
+        while(ready.load() != nthreads)
+        {
+            std::this_thread::yield();
+        }
+        clock::time_point start = clock::now();
+        go.store(true, std::memory_order_release);
+        for(std::thread& t : threads)
+        {
+            t.join();
+        }
+        return std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+
+    std::vector<std::size_t> thread_counts()
+    {
+        std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::size_t> counts;
+        for(std::size_t n = 1; n < hw; n *= 2)
+        {
+            counts.push_back(n);
+        }
+        counts.push_back(hw);
+        return counts;
+    }
+
+
+    namespace
+    {
+        const std::size_t sequence_length = 1 << 16;
+
+
+        template <typename Distribution>
+        size_sequence generate(const char* name, Distribution dist)
+        {
+            std::minstd_rand rng(42);
+            size_sequence seq{name, {}};
+            seq.sizes.reserve(sequence_length);
+            for(std::size_t i = 0; i < sequence_length; ++i)
+            {
+                seq.sizes.push_back(dist(rng));
+            }
+            return seq;
+        }
+
+
+        std::vector<size_sequence> make_distributions()
+        {
+            std::vector<size_sequence> result;
+            result.push_back(generate("fixed",
+                        [](std::minstd_rand&) { return std::size_t(64); }));
+
+            std::uniform_int_distribution<std::size_t> uniform(16, 1024);
+            result.push_back(generate("uniform",
+                        [&](std::minstd_rand& rng) { return uniform(rng); }));
+
+            std::lognormal_distribution<double> lognormal(std::log(64.0), 1.0);
+            result.push_back(generate("lognormal", [&](std::minstd_rand& rng) {
+                double size = std::round(lognormal(rng));
+                return static_cast<std::size_t>(
+                        std::min(std::max(size, 1.0), 65536.0));
+            }));
+
+            if(const char* path = std::getenv("PMR_BENCH_TRACE"))
+            {
+                size_sequence trace{"trace", {}};
+                try
+                {
+                    for(const pmr::trace_event& e : pmr::read_trace(path))
+                    {
+                        if(pmr::trace_event::allocate == e.op)
+                        {
+                            trace.sizes.push_back(
+                                    std::max<std::size_t>(e.bytes, 1));
+                        }
+                    }
+                }
+                catch(const std::runtime_error&)
+                {
+                    // not a recorded trace; read it as a list of sizes
+                    std::ifstream in{path};
+                    std::size_t size = 0;
+                    while(in >> size)
+                    {
+                        trace.sizes.push_back(std::max<std::size_t>(size, 1));
+                    }
+                }
+                if(trace.sizes.empty())
+                {
+                    std::fprintf(stderr, "no sizes read from %s\n", path);
+                }
+                else
+                {
+                    result.push_back(std::move(trace));
+                }
+            }
+            return result;
+        }
+    }
+
+
+    const std::vector<size_sequence>& size_distributions()
+    {
+        static const std::vector<size_sequence> distributions =
+            make_distributions();
+        return distributions;
+    }
+
+
+    double percentile(std::vector<double>& samples, double p)
+    {
+        if(samples.empty())
+        {
+            return 0.0;
+        }
+        std::size_t n = static_cast<std::size_t>(p * (samples.size() - 1));
+        std::nth_element(begin(samples), begin(samples) + n, end(samples));
+        return samples[n];
+    }
+}
+
+
+//! Usage: pmr-bench [name-substring...]
+//! Runs every registered benchmark whose name contains any of the arguments,
+//! or all of them if there are no arguments.
+int main(int argc, char* argv[])
+{
+    std::printf("benchmark,resource,sizes,threads,ops,seconds,ns_per_op,"
+            "mops_per_sec,p50_ns,p99_ns,version\n");
+    for(auto& entry : bench::registry())
+    {
+        bool selected = argc < 2;
+        for(int i = 1; i < argc; ++i)
+        {
+            selected = selected ||
+                std::string::npos != entry.first.find(argv[i]);
+        }
+        if(selected)
+        {
+            entry.second();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "pmr/memory_resource.h"
+#include "pmr/detail/config.h"
+#include "pmr/detail/memblocks.h"
+#include "pmr/detail/pool.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace pmr
+{
+    //! A linear allocator like monotonic_buffer_resource that any number of
+    //! threads may allocate from concurrently, for data built in parallel
+    //! whose lifetime ends together. Deallocations are no-ops; release()
+    //! frees everything.
+    //!
+    //! Threads claim space in the current upstream block with a single
+    //! atomic fetch-add. Only the thread that finds the block exhausted
+    //! takes a lock to chain a new one. Requests larger than half the
+    //! current block take the lock too, and those larger than half the
+    //! next block get a block of their own without displacing the current
+    //! one. Requests are rounded up to a multiple of the pointer size so
+    //! that the fetch-add alone keeps them aligned. Upstream blocks grow
+    //! geometrically.
+    class concurrent_monotonic_resource : public memory_resource
+    {
+      public:
+        //! Create an instance using the result of pmr::get_default_resource()
+        //! as its upstream memory_resource
+        concurrent_monotonic_resource() noexcept;
+
+        //! \param upstream the upstream memory_resource
+        explicit concurrent_monotonic_resource(
+                memory_resource* upstream) noexcept;
+
+        //! Create an instance whose first upstream block holds at least
+        //! initial_size bytes, taken from pmr::get_default_resource()
+        explicit concurrent_monotonic_resource(
+                std::size_t initial_size) noexcept;
+
+        //! Create an instance whose first upstream block holds at least
+        //! initial_size bytes, taken from upstream
+        concurrent_monotonic_resource(std::size_t initial_size,
+                memory_resource* upstream) noexcept;
+
+        concurrent_monotonic_resource(
+                const concurrent_monotonic_resource&) = delete;
+
+        //! Calls release()
+        ~concurrent_monotonic_resource();
+
+        concurrent_monotonic_resource& operator=(
+                const concurrent_monotonic_resource&) = delete;
+
+        //! Deallocate all blocks of memory allocated from upstream. Must not
+        //! be called concurrently with allocate.
+        void release();
+
+        //! Get this instance's upstream memory_resource
+        memory_resource* upstream_resource() const;
+
+      protected:
+        friend struct detail::resource_access;
+
+        void* do_allocate(std::size_t bytes, std::size_t align) override;
+
+        void do_deallocate(void*, std::size_t, std::size_t) override
+        {
+        }
+
+        bool do_is_equal(const memory_resource& other) const override;
+
+      private:
+        //! Heads an upstream block; allocations follow on the next
+        //! cache line
+        struct chunk
+        {
+            std::atomic<std::size_t> offset;
+            std::size_t size;
+        };
+
+        enum : std::size_t
+        {
+            granule = sizeof(void*),
+            header_size = detail::cache_line_size
+        };
+
+        //! The bytes to claim so that an aligned block of bytes fits
+        static std::size_t claim_size(
+                std::size_t bytes, std::size_t align) noexcept;
+
+        //! The aligned block in the claim at offset of c
+        static void* claimed(chunk* c, std::size_t offset,
+                std::size_t align) noexcept;
+
+        PMR_COLD void* allocate_from_next_chunk(
+                std::size_t bytes, std::size_t align);
+
+        memory_resource& m_upstream;
+        std::atomic<chunk*> m_current;
+        char m_pad[detail::cache_line_size]; // keeps m_lock's line apart
+        std::mutex m_lock;
+        std::size_t m_nextbuf_size;
+        std::size_t m_initial_size;
+        detail::memblocks m_blocks;
+    };
+
+
+    inline std::size_t
+    concurrent_monotonic_resource::claim_size(
+            std::size_t bytes, std::size_t align) noexcept
+    {
+        std::size_t size = (bytes + granule - 1) & ~std::size_t(granule - 1);
+        return align > granule ? size + align - granule : size;
+    }
+
+
+    inline void*
+    concurrent_monotonic_resource::claimed(
+            chunk* c, std::size_t offset, std::size_t align) noexcept
+    {
+        std::uintptr_t ptr = reinterpret_cast<std::uintptr_t>(c)
+            + header_size + offset;
+        return reinterpret_cast<void*>((ptr + align - 1) & ~(align - 1));
+    }
+
+
+    inline void*
+    concurrent_monotonic_resource::do_allocate(
+            std::size_t bytes, std::size_t align)
+    {
+        // a failed claim still moves the offset, so the fast path is only
+        // taken by requests small enough for that to waste little
+        std::size_t size = claim_size(bytes, align);
+        chunk* c = m_current.load(std::memory_order_acquire);
+        if(c && size >= bytes && size <= c->size / 2)
+        {
+            std::size_t offset =
+                c->offset.fetch_add(size, std::memory_order_relaxed);
+            if(offset <= c->size && size <= c->size - offset)
+            {
+                return claimed(c, offset, align);
+            }
+        }
+        return allocate_from_next_chunk(bytes, align);
+    }
+}
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/concurrent_monotonic_resource.ipp"
+#endif
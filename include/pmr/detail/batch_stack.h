@@ -0,0 +1,67 @@
+#pragma once
+
+#include "pmr/detail/config.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace pmr
+{
+    namespace detail
+    {
+        //! Overlays the first block of a batch of free blocks. The blocks of
+        //! a batch are chained through their first word; the first block
+        //! additionally links to the next batch on the stack.
+        struct batch_node
+        {
+            explicit batch_node(batch_node* n) noexcept
+                : next{n}
+                , next_batch{nullptr}
+            {
+            }
+
+            batch_node* next;
+            std::atomic<batch_node*> next_batch;
+        };
+
+
+        //! A lock-free LIFO of batches of free blocks. The head pointer
+        //! carries a modification count in its otherwise unused high bits to
+        //! defeat ABA. Popping reads the first word of the top batch
+        //! without owning it, so blocks must stay mapped while the stack is
+        //! in use, which holds for blocks carved from pool chunks.
+        //!
+        //! Batches at addresses using those high bits, as under 5-level
+        //! paging or with tagged pointers, go on a second stack guarded by
+        //! a mutex instead, which is only consulted when the first is empty.
+        class batch_stack
+        {
+          public:
+            batch_stack() noexcept;
+
+            batch_stack(const batch_stack&) = delete;
+            batch_stack& operator=(const batch_stack&) = delete;
+
+            //! Push a chain of blocks linked through batch_node::next
+            void push(batch_node* batch) noexcept;
+
+            //! \return The most recently pushed batch or nullptr if empty
+            batch_node* pop() noexcept;
+
+            //! Forget all batches. Not threadsafe.
+            void clear() noexcept;
+
+          private:
+            PMR_COLD void push_spilled(batch_node* batch) noexcept;
+            PMR_COLD batch_node* pop_spilled() noexcept;
+
+            std::atomic<std::uint64_t> m_head;
+            std::atomic<batch_node*> m_spilled; // written under m_spill_lock
+            std::mutex m_spill_lock;
+        };
+    }
+}
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/batch_stack.ipp"
+#endif
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace pmr
+{
+    namespace detail
+    {
+        //! A fixed size array of value-initialized T starting at a multiple
+        //! of alignof(T). new in C++11 only aligns to max_align_t, so types
+        //! aligned to a cache line to keep them apart from data written by
+        //! other threads are placed in storage obtained with room to spare.
+        template <typename T>
+        class cache_aligned_array
+        {
+          public:
+            cache_aligned_array() noexcept
+                : m_data{nullptr}
+                , m_size{0}
+            {
+            }
+
+            explicit cache_aligned_array(std::size_t n)
+                : m_storage{new char[n * sizeof(T) + alignof(T)]}
+                , m_data{nullptr}
+                , m_size{0}
+            {
+                void* p = m_storage.get();
+                std::size_t space = n * sizeof(T) + alignof(T);
+                m_data = static_cast<T*>(
+                        std::align(alignof(T), n * sizeof(T), p, space));
+                try
+                {
+                    for(; m_size < n; ++m_size)
+                    {
+                        ::new (m_data + m_size) T();
+                    }
+                }
+                catch(...)
+                {
+                    destroy();
+                    throw;
+                }
+            }
+
+            cache_aligned_array(const cache_aligned_array&) = delete;
+
+            cache_aligned_array& operator=(cache_aligned_array&& other)
+                noexcept
+            {
+                destroy();
+                m_storage = std::move(other.m_storage);
+                m_data = other.m_data;
+                m_size = other.m_size;
+                other.m_data = nullptr;
+                other.m_size = 0;
+                return *this;
+            }
+
+            ~cache_aligned_array()
+            {
+                destroy();
+            }
+
+            T& operator[](std::size_t i) const noexcept
+            {
+                return m_data[i];
+            }
+
+          private:
+            void destroy() noexcept
+            {
+                for(; m_size > 0; --m_size)
+                {
+                    m_data[m_size - 1].~T();
+                }
+            }
+
+            std::unique_ptr<char[]> m_storage;
+            T* m_data;
+            std::size_t m_size;
+        };
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+//! Defining PMR_HEADER_ONLY makes every header include its implementation
+//! from pmr/impl so that no library needs to be linked. PMR_DECL marks the
+//! out of line definitions there, which become inline in that mode.
+#ifdef PMR_HEADER_ONLY
+#   define PMR_DECL inline
+#else
+#   define PMR_DECL
+#endif
+
+//! Marks a rarely taken path so that header-only builds, where it is
+//! visible to its callers, keep it out of their hot loops
+#if defined(__GNUC__)
+#   define PMR_COLD __attribute__((cold))
+#else
+#   define PMR_COLD
+#endif
+
+//! Defined where mmap_resource and numa_resource are available, which need
+//! the POSIX memory mapping calls
+#if defined(__unix__) || defined(__APPLE__)
+#   define PMR_HAS_MMAP 1
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace pmr
@@ -8,22 +9,107 @@ namespace pmr
 
     namespace detail
     {
-        struct header
+        //! Describes one block obtained from upstream. Descriptors live out
+        //! of line so that blocks are requested with exactly the size and
+        //! alignment asked for, keeping power-of-two and page-sized
+        //! requests in their natural upstream size class.
+        struct block
         {
-            std::size_t size = 0; //sizeof(header) + block size
-            header* next = nullptr;
+            void* ptr;
+            std::size_t size;
+            std::size_t align;
         };
 
 
+        //! Tracks blocks allocated from an upstream memory_resource. The
+        //! first few descriptors are stored inline; beyond that they spill
+        //! into an array from upstream that grows geometrically and fills
+        //! whatever allocate_at_least() hands out, so that page-granular
+        //! upstreams are not left with slack. The spilled array comes with
+        //! a hash index from block address to descriptor so that
+        //! deallocate() does not search.
+        //!
+        //! Blocks in use are kept in allocation order followed by spare
+        //! blocks that were recycled but not yet returned upstream.
         class memblocks
         {
           public:
-            void* extend(std::size_t bytes, memory_resource& upstream);
+            void* extend(std::size_t bytes, memory_resource& upstream,
+                    std::size_t align = alignof(std::max_align_t));
+
+            // does not preserve the order of the remaining blocks
+            void deallocate(void* ptr, std::size_t bytes,
+                    memory_resource& upstream);
             void release(memory_resource& upstream);
 
+            // moves every block allocated after the first until blocks onto
+            // the spare list without freeing it
+            void recycle(std::size_t until = 0) noexcept;
+
+            // returns every spare block of at least min_size bytes to
+            // upstream
+            void trim(std::size_t min_size, memory_resource& upstream);
+
+            // the number of blocks in use, usable as until above
+            std::size_t top() const noexcept { return m_used; }
+
+            // the blocks in use, in the order they were obtained unless
+            // sort_in_use() has been called since
+            const block* in_use() const noexcept { return data(); }
+
+            // orders the blocks in use by address
+            void sort_in_use() noexcept;
+
+            // the number of blocks held, in use or spare
+            std::size_t count() const noexcept { return m_count; }
+
+            // the total size of the blocks held, in use or spare
+            std::size_t bytes() const noexcept;
+
+            // takes a spare block of at least bytes aligned to align,
+            // returning nullptr if there is none. capacity receives the
+            // usable size of the block.
+            void* reuse(std::size_t bytes, std::size_t align,
+                    std::size_t& capacity) noexcept;
+
           private:
-            header m_slist;
-            header* m_tail = &m_slist;
+            static constexpr std::size_t inline_capacity = 4;
+
+            //! Open addressing slot of the index, empty if ptr is nullptr
+            struct index_entry
+            {
+                void* ptr;
+                std::size_t pos;
+            };
+
+            block* data() noexcept;
+            const block* data() const noexcept;
+            void reserve_one(memory_resource& upstream);
+
+            // the size of a spilled array of capacity descriptors with its
+            // index
+            static std::size_t spill_bytes(std::size_t capacity) noexcept;
+
+            // the index has twice as many entries as there are descriptors;
+            // nullptr while they are inline
+            index_entry* index() noexcept;
+            index_entry* find(const void* ptr) noexcept;
+            void index_insert(void* ptr, std::size_t pos) noexcept;
+            void index_erase(index_entry* entry) noexcept;
+
+            // records that the block at pos of data() was moved there
+            void moved(std::size_t pos) noexcept;
+
+            block m_inline[inline_capacity];
+            block* m_spill = nullptr; // spilled array once inline is full
+            std::size_t m_spill_size = 0; // as obtained from upstream
+            std::size_t m_capacity = inline_capacity;
+            std::size_t m_used = 0; // blocks in use
+            std::size_t m_count = 0; // blocks in use plus spare blocks
         };
     }
 }
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/memblocks.ipp"
+#endif
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "pmr/detail/memblocks.h"
+#include "pmr/pool_options.h"
+#include "pmr/pool_statistics.h"
+#include <cstdint>
+
+namespace pmr
+{
+    class memory_resource;
+
+    namespace detail
+    {
+        //! Enumerators rather than constants so that inline functions
+        //! using them refer to the same entity in every translation unit
+        enum pool_geometry : std::size_t
+        {
+            //! Assumed size of a cache line; used to keep data written by
+            //! different threads apart
+            cache_line_size = 64,
+
+            //! Pool chunks are aligned to the smaller of their block size
+            //! and this, so every block is too. More strictly aligned
+            //! requests are not served from pools.
+            max_pool_block_align = cache_line_size,
+
+            //! Block size of the smallest pool; every block must be able to
+            //! hold a detail::batch_node
+            min_pool_block_size = 2 * sizeof(void*)
+        };
+
+
+        //! Fills in defaults for zero-valued hints and clamps the rest to
+        //! implementation limits. largest_required_pool_block is rounded up
+        //! to a power of two.
+        pool_options normalize(const pool_options& opts) noexcept;
+
+
+        //! The number of power-of-two pools needed to serve blocks up to and
+        //! including opts.largest_required_pool_block
+        std::size_t pool_count(const pool_options& opts) noexcept;
+
+
+        //! The index of the smallest power-of-two pool with blocks of at
+        //! least the given size
+        inline std::size_t pool_index(std::size_t bytes) noexcept
+        {
+            if(bytes <= min_pool_block_size)
+            {
+                return 0;
+            }
+#           if defined(__GNUC__)
+            constexpr int digits = 8 * sizeof(unsigned long long);
+            return (digits - __builtin_clzll(bytes - 1))
+                - (digits - 1 - __builtin_clzll(min_pool_block_size));
+#           else
+            std::size_t index = 0;
+            for(std::size_t size = min_pool_block_size; size < bytes; size <<= 1)
+            {
+                ++index;
+            }
+            return index;
+#           endif
+        }
+
+
+        //! Serves fixed-size blocks from an intrusive freelist backed by
+        //! chunks of memory requested from an upstream memory_resource.
+        //! Chunks start small and grow geometrically up to
+        //! max_blocks_per_chunk blocks.
+        class pool
+        {
+          public:
+            pool(std::size_t block_size,
+                    std::size_t max_blocks_per_chunk) noexcept;
+
+            void* allocate(memory_resource& upstream);
+            void allocate(void** out, std::size_t n, memory_resource& upstream);
+            void deallocate(void* ptr) noexcept;
+            void deallocate(void* const* ptrs, std::size_t n) noexcept;
+            void release(memory_resource& upstream);
+
+            std::size_t block_size() const noexcept;
+
+            // used_blocks counts blocks handed out by this pool and not
+            // returned to it
+            pool_statistics stats() const noexcept;
+
+          private:
+            struct free_block
+            {
+                free_block* next;
+            };
+
+            void extend(memory_resource& upstream);
+            std::size_t initial_blocks_per_chunk() const noexcept;
+            void recalculate_next_chunk_size() noexcept;
+
+            std::size_t m_block_size;
+            std::size_t m_max_blocks_per_chunk;
+            std::size_t m_next_blocks_per_chunk;
+            free_block* m_free = nullptr;
+            char* m_next = nullptr; // uncarved remainder of the newest chunk
+            char* m_end = nullptr;
+            std::size_t m_used = 0;
+            memblocks m_chunks;
+        };
+    }
+}
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/pool.ipp"
+#endif
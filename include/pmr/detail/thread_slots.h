@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace pmr
+{
+    namespace detail
+    {
+        // Each thread remembers its shards of recently used resources in a
+        // small direct-mapped table; a resource evicted from it looks up the
+        // thread's shard in its shard_map on its next call, or makes one.
+        // Resource ids are never reused so entries of destroyed resources
+        // never match. Function-local so that header-only builds share one
+        // instance.
+
+        enum shard_slot_count : std::size_t
+        {
+            shard_slots = 8
+        };
+
+        struct shard_slot
+        {
+            std::uint64_t id;
+            void* shard;
+        };
+
+
+        inline std::atomic<std::uint64_t>& next_shard_id() noexcept
+        {
+            static std::atomic<std::uint64_t> id{1};
+            return id;
+        }
+
+
+        // trivially destructible so access needs no initialization guard
+        inline shard_slot* shard_slots_table() noexcept
+        {
+            static thread_local shard_slot t_slots[shard_slots];
+            return t_slots;
+        }
+
+
+        inline shard_slot& shard_slot_for(std::uint64_t id) noexcept
+        {
+            return shard_slots_table()[id % shard_slots];
+        }
+
+
+        //! A resource's shards by thread, for threads whose slot no longer
+        //! holds it. Lookups are lock-free so that resources sharing a slot
+        //! do not serialise their callers; inserts must be serialised by the
+        //! caller. A full table is replaced by one twice the size and kept
+        //! until destruction, as lookups may still be reading it.
+        class shard_map
+        {
+          public:
+            shard_map() noexcept
+                : m_table{nullptr}
+            {
+            }
+
+            shard_map(const shard_map&) = delete;
+            shard_map& operator=(const shard_map&) = delete;
+
+            ~shard_map()
+            {
+                delete m_table.load(std::memory_order_relaxed);
+            }
+
+            //! \returns The shard of thread or nullptr if it has none
+            void* find(std::thread::id thread) const noexcept
+            {
+                const table* t = m_table.load(std::memory_order_acquire);
+                if(!t)
+                {
+                    return nullptr;
+                }
+                for(std::size_t i = t->home(thread); ; i = (i + 1) & t->mask)
+                {
+                    std::thread::id key =
+                        t->entries[i].thread.load(std::memory_order_acquire);
+                    if(key == thread)
+                    {
+                        return t->entries[i].shard.load(
+                                std::memory_order_relaxed);
+                    }
+                    if(key == std::thread::id{})
+                    {
+                        return nullptr;
+                    }
+                }
+            }
+
+            //! Add the shard of thread, which must not have one yet
+            void insert(std::thread::id thread, void* shard)
+            {
+                table* t = m_table.load(std::memory_order_relaxed);
+                if(!t || 2 * (t->used + 1) > t->mask + 1)
+                {
+                    std::unique_ptr<table> bigger{
+                        new table{t ? 2 * (t->mask + 1) : 16}};
+                    for(std::size_t i = 0; t && i <= t->mask; ++i)
+                    {
+                        std::thread::id key = t->entries[i].thread.load(
+                                std::memory_order_relaxed);
+                        if(key != std::thread::id{})
+                        {
+                            bigger->put(key, t->entries[i].shard.load(
+                                        std::memory_order_relaxed));
+                        }
+                    }
+                    bigger->previous.reset(t);
+                    t = bigger.release();
+                    m_table.store(t, std::memory_order_release);
+                }
+                t->put(thread, shard);
+            }
+
+          private:
+            struct entry
+            {
+                std::atomic<std::thread::id> thread;
+                std::atomic<void*> shard;
+            };
+
+            struct table
+            {
+                explicit table(std::size_t size)
+                    : mask{size - 1}
+                    , entries{new entry[size]}
+                {
+                    for(std::size_t i = 0; i < size; ++i)
+                    {
+                        entries[i].thread.store(std::thread::id{},
+                                std::memory_order_relaxed);
+                        entries[i].shard.store(nullptr,
+                                std::memory_order_relaxed);
+                    }
+                }
+
+                std::size_t home(std::thread::id thread) const noexcept
+                {
+                    std::uint64_t h = static_cast<std::uint64_t>(
+                            std::hash<std::thread::id>{}(thread))
+                        * UINT64_C(0x9e3779b97f4a7c15);
+                    return static_cast<std::size_t>(h >> 32) & mask;
+                }
+
+                // the shard is published before the key that finds it
+                void put(std::thread::id thread, void* shard) noexcept
+                {
+                    std::size_t i = home(thread);
+                    while(entries[i].thread.load(std::memory_order_relaxed)
+                            != std::thread::id{})
+                    {
+                        i = (i + 1) & mask;
+                    }
+                    entries[i].shard.store(shard, std::memory_order_relaxed);
+                    entries[i].thread.store(thread, std::memory_order_release);
+                    ++used;
+                }
+
+                std::size_t mask;
+                std::size_t used = 0;
+                std::unique_ptr<entry[]> entries;
+                std::unique_ptr<table> previous;
+            };
+
+            std::atomic<table*> m_table;
+        };
+    }
+}
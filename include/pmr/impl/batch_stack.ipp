@@ -0,0 +1,125 @@
+#pragma once
+
+#include "pmr/detail/batch_stack.h"
+#include "pmr/detail/config.h"
+#include <cassert>
+
+namespace pmr
+{
+    namespace detail
+    {
+        // user space addresses usually fit in 48 bits on 64-bit targets,
+        // leaving 16 bits for the modification count; those that do not
+        // are spilled
+        enum tag_layout : std::uint64_t
+        {
+            ptr_bits = sizeof(void*) == 8 ? 48 : 32,
+            ptr_mask = (std::uint64_t(1) << ptr_bits) - 1
+        };
+
+
+        inline bool fits_tag(const batch_node* node) noexcept
+        {
+            return 0 == (static_cast<std::uint64_t>(
+                        reinterpret_cast<std::uintptr_t>(node)) & ~ptr_mask);
+        }
+
+
+        inline batch_node* untag(std::uint64_t tagged) noexcept
+        {
+            return reinterpret_cast<batch_node*>(
+                    static_cast<std::uintptr_t>(tagged & ptr_mask));
+        }
+
+
+        inline std::uint64_t retag(batch_node* node, std::uint64_t old) noexcept
+        {
+            assert(fits_tag(node));
+            std::uint64_t tag = (old >> ptr_bits) + 1;
+            return (tag << ptr_bits) |
+                static_cast<std::uint64_t>(
+                        reinterpret_cast<std::uintptr_t>(node));
+        }
+
+
+        PMR_DECL
+        batch_stack::batch_stack() noexcept
+            : m_head{0}
+            , m_spilled{nullptr}
+        {
+        }
+
+
+        PMR_DECL void
+        batch_stack::push(batch_node* batch) noexcept
+        {
+            if(!fits_tag(batch))
+            {
+                return push_spilled(batch);
+            }
+            std::uint64_t old = m_head.load(std::memory_order_relaxed);
+            do
+            {
+                batch->next_batch.store(untag(old), std::memory_order_relaxed);
+            } while(!m_head.compare_exchange_weak(old, retag(batch, old),
+                        std::memory_order_release, std::memory_order_relaxed));
+        }
+
+
+        PMR_DECL batch_node*
+        batch_stack::pop() noexcept
+        {
+            std::uint64_t old = m_head.load(std::memory_order_acquire);
+            for(;;)
+            {
+                batch_node* top = untag(old);
+                if(!top)
+                {
+                    return m_spilled.load(std::memory_order_relaxed)
+                        ? pop_spilled() : nullptr;
+                }
+                // may be stale if another thread pops top first, in which
+                // case the count in m_head has moved on and the CAS fails
+                batch_node* next = top->next_batch.load(std::memory_order_relaxed);
+                if(m_head.compare_exchange_weak(old, retag(next, old),
+                            std::memory_order_acquire,
+                            std::memory_order_acquire))
+                {
+                    return top;
+                }
+            }
+        }
+
+
+        PMR_DECL void
+        batch_stack::clear() noexcept
+        {
+            m_head.store(0, std::memory_order_relaxed);
+            m_spilled.store(nullptr, std::memory_order_relaxed);
+        }
+
+
+        PMR_DECL void
+        batch_stack::push_spilled(batch_node* batch) noexcept
+        {
+            std::lock_guard<std::mutex> guard{m_spill_lock};
+            batch->next_batch.store(m_spilled.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+            m_spilled.store(batch, std::memory_order_relaxed);
+        }
+
+
+        PMR_DECL batch_node*
+        batch_stack::pop_spilled() noexcept
+        {
+            std::lock_guard<std::mutex> guard{m_spill_lock};
+            batch_node* top = m_spilled.load(std::memory_order_relaxed);
+            if(top)
+            {
+                m_spilled.store(top->next_batch.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+            }
+            return top;
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "pmr/concurrent_monotonic_resource.h"
+#include "pmr/detail/config.h"
+#include <algorithm>
+#include <limits>
+#include <new>
+
+namespace pmr
+{
+    namespace detail
+    {
+        enum concurrent_defaults : std::size_t
+        {
+            concurrent_initial_size = 4096
+        };
+    }
+
+
+    PMR_DECL
+    concurrent_monotonic_resource::concurrent_monotonic_resource() noexcept
+        : concurrent_monotonic_resource(
+                detail::concurrent_initial_size, nullptr)
+    {
+    }
+
+
+    PMR_DECL
+    concurrent_monotonic_resource::concurrent_monotonic_resource(
+            memory_resource* upstream) noexcept
+        : concurrent_monotonic_resource(
+                detail::concurrent_initial_size, upstream)
+    {
+    }
+
+
+    PMR_DECL
+    concurrent_monotonic_resource::concurrent_monotonic_resource(
+            std::size_t initial_size) noexcept
+        : concurrent_monotonic_resource(initial_size, nullptr)
+    {
+    }
+
+
+    PMR_DECL
+    concurrent_monotonic_resource::concurrent_monotonic_resource(
+            std::size_t initial_size, memory_resource* upstream) noexcept
+        : m_upstream{upstream ? *upstream : *get_default_resource()}
+        , m_current{nullptr}
+        , m_nextbuf_size{std::max<std::size_t>(initial_size,
+                detail::concurrent_initial_size)}
+        , m_initial_size{m_nextbuf_size}
+    {
+    }
+
+
+    PMR_DECL
+    concurrent_monotonic_resource::~concurrent_monotonic_resource()
+    {
+        release();
+    }
+
+
+    PMR_DECL void
+    concurrent_monotonic_resource::release()
+    {
+        m_current.store(nullptr, std::memory_order_relaxed);
+        m_blocks.release(m_upstream);
+        m_nextbuf_size = m_initial_size;
+    }
+
+
+    PMR_DECL memory_resource*
+    concurrent_monotonic_resource::upstream_resource() const
+    {
+        return &m_upstream;
+    }
+
+
+    PMR_DECL bool
+    concurrent_monotonic_resource::do_is_equal(
+            const memory_resource& other) const
+    {
+        return this == &other;
+    }
+
+
+    PMR_DECL void*
+    concurrent_monotonic_resource::allocate_from_next_chunk(
+            std::size_t bytes, std::size_t align)
+    {
+        std::size_t size = claim_size(bytes, align);
+        if(size < bytes
+                || size > std::numeric_limits<std::size_t>::max() / 2)
+        {
+            throw std::bad_alloc();
+        }
+
+        std::lock_guard<std::mutex> guard{m_lock};
+
+        // another thread may have chained a block while we waited; claim
+        // without moving the offset past the end should it not fit
+        chunk* c = m_current.load(std::memory_order_relaxed);
+        if(c)
+        {
+            std::size_t offset = c->offset.load(std::memory_order_relaxed);
+            while(offset <= c->size && size <= c->size - offset)
+            {
+                if(c->offset.compare_exchange_weak(offset, offset + size,
+                            std::memory_order_relaxed))
+                {
+                    return claimed(c, offset, align);
+                }
+            }
+        }
+
+        if(size > m_nextbuf_size / 2)
+        {
+            // a block of its own, leaving the current one to the others
+            return m_blocks.extend(bytes, m_upstream,
+                    std::max(align, alignof(std::max_align_t)));
+        }
+
+        void* block = m_blocks.extend(m_nextbuf_size, m_upstream,
+                std::max<std::size_t>(header_size, alignof(std::max_align_t)));
+        c = ::new (block) chunk;
+        c->offset.store(size, std::memory_order_relaxed);
+        c->size = m_nextbuf_size - header_size;
+        m_current.store(c, std::memory_order_release);
+        if(m_nextbuf_size <= std::numeric_limits<std::size_t>::max() / 2)
+        {
+            m_nextbuf_size *= 2;
+        }
+        return claimed(c, 0, align);
+    }
+}
@@ -0,0 +1,335 @@
+#pragma once
+
+#include "pmr/detail/memblocks.h"
+#include "pmr/detail/config.h"
+#include "pmr/memory_resource.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+
+namespace pmr
+{
+    namespace detail
+    {
+        // blocks are at least pointer aligned, so the low bits carry
+        // little; the multiplication spreads the rest over the high bits
+        inline std::size_t block_hash(const void* ptr, std::size_t entries)
+            noexcept
+        {
+            std::uint64_t h = static_cast<std::uint64_t>(
+                    reinterpret_cast<std::uintptr_t>(ptr))
+                * UINT64_C(0x9e3779b97f4a7c15);
+            return static_cast<std::size_t>(h >> 32) & (entries - 1);
+        }
+
+
+        PMR_DECL block*
+        memblocks::data() noexcept
+        {
+            return m_spill ? m_spill : m_inline;
+        }
+
+
+        PMR_DECL const block*
+        memblocks::data() const noexcept
+        {
+            return m_spill ? m_spill : m_inline;
+        }
+
+
+        PMR_DECL std::size_t
+        memblocks::bytes() const noexcept
+        {
+            const block* blocks = data();
+            std::size_t total = 0;
+            for(std::size_t i = 0; i < m_count; ++i)
+            {
+                total += blocks[i].size;
+            }
+            return total;
+        }
+
+
+        PMR_DECL std::size_t
+        memblocks::spill_bytes(std::size_t capacity) noexcept
+        {
+            return capacity * (sizeof(block) + 2 * sizeof(index_entry));
+        }
+
+
+        PMR_DECL void
+        memblocks::reserve_one(memory_resource& upstream)
+        {
+            if(m_count < m_capacity)
+            {
+                return;
+            }
+            if(std::numeric_limits<std::size_t>::max() / 4 / spill_bytes(1) <
+                    m_capacity)
+            {
+                throw std::bad_alloc();
+            }
+
+            // page-granular upstreams round up, so use what they hand out
+            std::size_t capacity = m_capacity * 2;
+            allocation_result<void*> r = upstream.allocate_at_least(
+                    spill_bytes(capacity), alignof(block));
+            while(spill_bytes(capacity * 2) <= r.count)
+            {
+                capacity *= 2;
+            }
+            block* spill = static_cast<block*>(r.ptr);
+            std::memcpy(spill, data(), m_count * sizeof(block));
+            if(m_spill)
+            {
+                upstream.deallocate(m_spill, m_spill_size, alignof(block));
+            }
+            m_spill = spill;
+            m_spill_size = r.count;
+            m_capacity = capacity;
+
+            index_entry* entries = index();
+            std::fill(entries, entries + 2 * m_capacity,
+                    index_entry{nullptr, 0});
+            for(std::size_t i = 0; i < m_count; ++i)
+            {
+                index_insert(spill[i].ptr, i);
+            }
+        }
+
+
+        PMR_DECL memblocks::index_entry*
+        memblocks::index() noexcept
+        {
+            return m_spill
+                ? reinterpret_cast<index_entry*>(m_spill + m_capacity)
+                : nullptr;
+        }
+
+
+        PMR_DECL memblocks::index_entry*
+        memblocks::find(const void* ptr) noexcept
+        {
+            index_entry* entries = index();
+            std::size_t mask = 2 * m_capacity - 1;
+            std::size_t i = block_hash(ptr, mask + 1);
+            while(entries[i].ptr != ptr)
+            {
+                assert(entries[i].ptr);
+                i = (i + 1) & mask;
+            }
+            return &entries[i];
+        }
+
+
+        PMR_DECL void
+        memblocks::index_insert(void* ptr, std::size_t pos) noexcept
+        {
+            assert(ptr);
+            index_entry* entries = index();
+            std::size_t mask = 2 * m_capacity - 1;
+            std::size_t i = block_hash(ptr, mask + 1);
+            while(entries[i].ptr)
+            {
+                i = (i + 1) & mask;
+            }
+            entries[i] = index_entry{ptr, pos};
+        }
+
+
+        PMR_DECL void
+        memblocks::index_erase(index_entry* entry) noexcept
+        {
+            // shift later entries of the probe sequence back into the hole
+            // unless that would put them before their home slot
+            index_entry* entries = index();
+            std::size_t mask = 2 * m_capacity - 1;
+            std::size_t hole = static_cast<std::size_t>(entry - entries);
+            for(std::size_t i = (hole + 1) & mask; entries[i].ptr;
+                    i = (i + 1) & mask)
+            {
+                std::size_t home = block_hash(entries[i].ptr, mask + 1);
+                if(((i - home) & mask) >= ((i - hole) & mask))
+                {
+                    entries[hole] = entries[i];
+                    hole = i;
+                }
+            }
+            entries[hole].ptr = nullptr;
+        }
+
+
+        PMR_DECL void
+        memblocks::moved(std::size_t pos) noexcept
+        {
+            if(m_spill)
+            {
+                find(data()[pos].ptr)->pos = pos;
+            }
+        }
+
+
+        PMR_DECL void*
+        memblocks::extend(std::size_t bytes, memory_resource& upstream,
+                std::size_t align)
+        {
+            reserve_one(upstream);
+            void* ptr = upstream.allocate(bytes, align);
+
+            // the first spare, if any, moves to the end to make room
+            block* blocks = data();
+            if(m_used != m_count)
+            {
+                blocks[m_count] = blocks[m_used];
+                moved(m_count);
+            }
+            ++m_count;
+            blocks[m_used] = block{ptr, bytes, align};
+            if(m_spill)
+            {
+                index_insert(ptr, m_used);
+            }
+            ++m_used;
+            return ptr;
+        }
+
+
+        PMR_DECL void
+        memblocks::deallocate(void* ptr, std::size_t bytes,
+                memory_resource& upstream)
+        {
+            block* blocks = data();
+            std::size_t i = m_used;
+            if(m_spill)
+            {
+                index_entry* entry = find(ptr);
+                i = entry->pos;
+                index_erase(entry);
+            }
+            else
+            {
+                // only a few inline descriptors to search
+                do
+                {
+                    assert(i);
+                    --i;
+                } while(blocks[i].ptr != ptr);
+            }
+            assert(i < m_used);
+            assert(blocks[i].size == bytes);
+            (void)bytes;
+
+            std::size_t align = blocks[i].align;
+            if(i != --m_used)
+            {
+                blocks[i] = blocks[m_used];
+                moved(i);
+            }
+            if(m_used != --m_count)
+            {
+                blocks[m_used] = blocks[m_count];
+                moved(m_used);
+            }
+            upstream.deallocate(ptr, bytes, align);
+        }
+
+
+        PMR_DECL void
+        memblocks::release(memory_resource& upstream)
+        {
+            block* blocks = data();
+            for(std::size_t i = m_count; i > 0; --i)
+            {
+                const block& b = blocks[i - 1];
+                upstream.deallocate(b.ptr, b.size, b.align);
+            }
+            if(m_spill)
+            {
+                upstream.deallocate(m_spill, m_spill_size, alignof(block));
+                m_spill = nullptr;
+                m_spill_size = 0;
+                m_capacity = inline_capacity;
+            }
+            m_used = 0;
+            m_count = 0;
+        }
+
+
+        PMR_DECL void
+        memblocks::trim(std::size_t min_size, memory_resource& upstream)
+        {
+            // from the back so that the block moved into a hole has
+            // already been looked at
+            block* blocks = data();
+            for(std::size_t i = m_count; i > m_used; --i)
+            {
+                block b = blocks[i - 1];
+                if(b.size < min_size)
+                {
+                    continue;
+                }
+                if(m_spill)
+                {
+                    index_erase(find(b.ptr));
+                }
+                if(i - 1 != --m_count)
+                {
+                    blocks[i - 1] = blocks[m_count];
+                    moved(i - 1);
+                }
+                upstream.deallocate(b.ptr, b.size, b.align);
+            }
+        }
+
+
+        PMR_DECL void
+        memblocks::sort_in_use() noexcept
+        {
+            block* blocks = data();
+            std::sort(blocks, blocks + m_used,
+                    [](const block& a, const block& b) {
+                        return std::less<void*>()(a.ptr, b.ptr);
+                    });
+            for(std::size_t i = 0; i < m_used; ++i)
+            {
+                moved(i);
+            }
+        }
+
+
+        PMR_DECL void
+        memblocks::recycle(std::size_t until) noexcept
+        {
+            assert(until <= m_used);
+            m_used = until;
+        }
+
+
+        PMR_DECL void*
+        memblocks::reuse(std::size_t bytes, std::size_t align,
+                std::size_t& capacity) noexcept
+        {
+            block* blocks = data();
+            for(std::size_t i = m_used; i < m_count; ++i)
+            {
+                if(blocks[i].size >= bytes &&
+                        0 == reinterpret_cast<std::uintptr_t>(blocks[i].ptr) % align)
+                {
+                    if(i != m_used)
+                    {
+                        std::swap(blocks[i], blocks[m_used]);
+                        moved(i);
+                        moved(m_used);
+                    }
+                    capacity = blocks[m_used].size;
+                    return blocks[m_used++].ptr;
+                }
+            }
+            return nullptr;
+        }
+    }
+}
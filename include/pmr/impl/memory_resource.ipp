@@ -0,0 +1,206 @@
+#pragma once
+
+#include "pmr/memory_resource.h"
+#include "pmr/detail/config.h"
+#include "pmr/resource_adapter.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <new>
+#include <type_traits>
+
+namespace pmr
+{
+    PMR_DECL
+    memory_resource::~memory_resource()
+    {
+    }
+
+
+    PMR_DECL allocation_result<void*>
+    memory_resource::allocate_at_least(std::size_t bytes, std::size_t align)
+    {
+        assert(align > 0);
+        assert(!(align & (align - 1)));
+
+        if(0 == bytes)
+        {
+            return {nullptr, 0};
+        }
+        allocation_result<void*> result = do_allocate_at_least(bytes, align);
+        assert(result.count >= bytes);
+        return result;
+    }
+
+
+    PMR_DECL void
+    memory_resource::allocate_bulk(void** out, std::size_t n,
+            std::size_t bytes, std::size_t align)
+    {
+        assert(align > 0);
+        assert(!(align & (align - 1)));
+
+        if(0 == bytes)
+        {
+            std::fill(out, out + n, nullptr);
+            return;
+        }
+        if(n)
+        {
+            do_allocate_bulk(out, n, bytes, align);
+        }
+    }
+
+
+    PMR_DECL void
+    memory_resource::deallocate_bulk(void* const* ptrs, std::size_t n,
+            std::size_t bytes, std::size_t align)
+    {
+        if(n)
+        {
+            do_deallocate_bulk(ptrs, n, bytes, align);
+        }
+    }
+
+
+    PMR_DECL allocation_result<void*>
+    memory_resource::do_allocate_at_least(std::size_t bytes, std::size_t align)
+    {
+        return {do_allocate(bytes, align), bytes};
+    }
+
+
+    PMR_DECL void
+    memory_resource::do_allocate_bulk(void** out, std::size_t n,
+            std::size_t bytes, std::size_t align)
+    {
+        std::size_t i = 0;
+        try
+        {
+            for(; i < n; ++i)
+            {
+                out[i] = do_allocate(bytes, align);
+            }
+        }
+        catch(...)
+        {
+            do_deallocate_bulk(out, i, bytes, align);
+            throw;
+        }
+    }
+
+
+    PMR_DECL void
+    memory_resource::do_deallocate_bulk(void* const* ptrs, std::size_t n,
+            std::size_t bytes, std::size_t align)
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            do_deallocate(ptrs[i], bytes, align);
+        }
+    }
+
+
+    PMR_DECL bool
+    memory_resource::is_equal(const memory_resource& other) const noexcept
+    {
+        return do_is_equal(other);
+    }
+
+
+    PMR_DECL bool operator==(const memory_resource& lhs,
+            const memory_resource& rhs) noexcept
+    {
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+
+
+    PMR_DECL bool operator!=(const memory_resource& lhs,
+            const memory_resource& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+
+    namespace detail
+    {
+        class null_memory_resource_impl : public memory_resource
+        {
+          public:
+            void* do_allocate(std::size_t, std::size_t)
+            {
+                throw std::bad_alloc();
+            }
+
+
+            void do_deallocate(void*, std::size_t, std::size_t)
+            {
+            }
+
+
+            bool do_is_equal(const memory_resource& other) const noexcept
+            {
+                return this == &other;
+            }
+        };
+    }
+
+    PMR_DECL memory_resource* new_delete_resource() noexcept
+    {
+        static resource_adapter<std::allocator<char>> mr;
+        return &mr;
+    }
+
+
+    PMR_DECL memory_resource* null_memory_resource() noexcept
+    {
+        static detail::null_memory_resource_impl mr;
+        return &mr;
+    }
+
+
+    namespace detail
+    {
+        // function-local so that header-only builds share one instance
+        PMR_DECL std::atomic<memory_resource*>& default_resource() noexcept
+        {
+            static std::atomic<memory_resource*> mr{new_delete_resource()};
+            return mr;
+        }
+
+
+        // nullptr unless the thread installed its own default; a trivially
+        // destructible thread_local needs no initialization guard
+        PMR_DECL memory_resource*& thread_default_resource() noexcept
+        {
+            static thread_local memory_resource* t_mr = nullptr;
+            return t_mr;
+        }
+    }
+
+
+    PMR_DECL memory_resource* get_default_resource() noexcept
+    {
+        if(memory_resource* mr = detail::thread_default_resource())
+        {
+            return mr;
+        }
+        return detail::default_resource().load(std::memory_order_acquire);
+    }
+
+
+    PMR_DECL memory_resource* set_default_resource(memory_resource* mr) noexcept
+    {
+        return detail::default_resource().exchange(
+                mr ? mr : new_delete_resource(), std::memory_order_release);
+    }
+
+
+    PMR_DECL memory_resource*
+    set_thread_default_resource(memory_resource* mr) noexcept
+    {
+        memory_resource* previous = detail::thread_default_resource();
+        detail::thread_default_resource() = mr;
+        return previous;
+    }
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "pmr/mmap_resource.h"
+#include "pmr/detail/config.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <new>
+
+#ifdef PMR_HAS_MMAP
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace pmr
+{
+    namespace detail
+    {
+        // the common huge page size on x86-64 and aarch64 with 4KiB pages,
+        // for systems that do not say
+        enum page_sizes : std::size_t
+        {
+            fallback_huge_page_size = 2 * 1024 * 1024
+        };
+
+
+        PMR_DECL std::size_t system_page_size() noexcept
+        {
+            long size = ::sysconf(_SC_PAGESIZE);
+            return size > 0 ? static_cast<std::size_t>(size) : 4096;
+        }
+
+
+        PMR_DECL std::size_t read_huge_page_size() noexcept
+        {
+            // a line such as "Hugepagesize:       2048 kB"
+            std::FILE* f = std::fopen("/proc/meminfo", "r");
+            if(!f)
+            {
+                return fallback_huge_page_size;
+            }
+            std::size_t result = fallback_huge_page_size;
+            char line[256];
+            while(std::fgets(line, sizeof(line), f))
+            {
+                unsigned long kib = 0;
+                if(0 == std::strncmp(line, "Hugepagesize:", 13) &&
+                        1 == std::sscanf(line + 13, "%lu", &kib) &&
+                        kib && 0 == (kib & (kib - 1)))
+                {
+                    result = static_cast<std::size_t>(kib) * 1024;
+                    break;
+                }
+            }
+            std::fclose(f);
+            return result;
+        }
+
+
+        PMR_DECL std::size_t system_huge_page_size() noexcept
+        {
+            static const std::size_t size = read_huge_page_size();
+            return size;
+        }
+
+
+        // MAP_HUGETLB uses the default huge page size unless the flags
+        // carry the log2 of another one
+        PMR_DECL int huge_page_flags(std::size_t page) noexcept
+        {
+            int flags = 0;
+#           ifdef MAP_HUGETLB
+            flags = MAP_HUGETLB;
+#           ifdef MAP_HUGE_SHIFT
+            if(page != system_huge_page_size())
+            {
+                int shift = 0;
+                while((std::size_t(1) << shift) < page)
+                {
+                    ++shift;
+                }
+                flags |= shift << MAP_HUGE_SHIFT;
+            }
+#           endif
+#           endif
+            (void)page;
+            return flags;
+        }
+
+
+        PMR_DECL void* map_anonymous(std::size_t length, int flags) noexcept
+        {
+            void* ptr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+            return MAP_FAILED == ptr ? nullptr : ptr;
+        }
+
+
+        // maps length bytes at an address aligned to align by mapping
+        // extra and trimming the misaligned head and tail
+        PMR_DECL void* map_aligned(std::size_t length, std::size_t align,
+                std::size_t page) noexcept
+        {
+            if(align <= page)
+            {
+                return map_anonymous(length, 0);
+            }
+            if(std::numeric_limits<std::size_t>::max() - length < align - page)
+            {
+                return nullptr;
+            }
+            std::size_t padded = length + align - page;
+            char* raw = static_cast<char*>(map_anonymous(padded, 0));
+            if(!raw)
+            {
+                return nullptr;
+            }
+            std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw);
+            char* aligned = raw + (align - addr % align) % align;
+            if(aligned != raw)
+            {
+                ::munmap(raw, aligned - raw);
+            }
+            std::size_t tail = (raw + padded) - (aligned + length);
+            if(tail)
+            {
+                ::munmap(aligned + length, tail);
+            }
+            return aligned;
+        }
+    }
+
+
+    PMR_DECL
+    mmap_resource::mmap_resource() noexcept
+        : mmap_resource(page_mode::normal)
+    {
+    }
+
+
+    PMR_DECL
+    mmap_resource::mmap_resource(page_mode mode) noexcept
+        : mmap_resource(mode, detail::system_huge_page_size())
+    {
+    }
+
+
+    PMR_DECL
+    mmap_resource::mmap_resource(page_mode mode,
+            std::size_t huge_page_size) noexcept
+        : m_mode{mode}
+        , m_page_size{page_mode::normal == mode
+            ? detail::system_page_size()
+            : std::max<std::size_t>(detail::system_page_size(),
+                    huge_page_size)}
+    {
+        assert(0 == (huge_page_size & (huge_page_size - 1)));
+    }
+
+
+    PMR_DECL mmap_resource::page_mode
+    mmap_resource::mode() const noexcept
+    {
+        return m_mode;
+    }
+
+
+    PMR_DECL std::size_t
+    mmap_resource::page_size() const noexcept
+    {
+        return m_page_size;
+    }
+
+
+    PMR_DECL void*
+    mmap_resource::do_allocate(std::size_t bytes, std::size_t align)
+    {
+        std::size_t length = mapping_size(bytes);
+        void* ptr = nullptr;
+#       ifdef MAP_HUGETLB
+        if(page_mode::huge == m_mode && align <= m_page_size)
+        {
+            ptr = detail::map_anonymous(length,
+                    detail::huge_page_flags(m_page_size));
+        }
+#       endif
+        if(!ptr)
+        {
+            // huge page sized modes align to huge pages so that the kernel
+            // can back the whole mapping with them
+            ptr = detail::map_aligned(length, std::max(align, m_page_size),
+                    detail::system_page_size());
+#           ifdef MADV_HUGEPAGE
+            if(ptr && page_mode::normal != m_mode)
+            {
+                ::madvise(ptr, length, MADV_HUGEPAGE);
+            }
+#           endif
+        }
+        if(!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+
+    PMR_DECL allocation_result<void*>
+    mmap_resource::do_allocate_at_least(std::size_t bytes, std::size_t align)
+    {
+        return {mmap_resource::do_allocate(bytes, align), mapping_size(bytes)};
+    }
+
+
+    PMR_DECL void
+    mmap_resource::do_deallocate(void* ptr, std::size_t bytes, std::size_t)
+    {
+        ::munmap(ptr, mapping_size(bytes));
+    }
+
+
+    PMR_DECL bool
+    mmap_resource::do_is_equal(const memory_resource& other) const
+    {
+        if(const mmap_resource* p = dynamic_cast<const mmap_resource*>(&other))
+        {
+            return m_mode == p->m_mode && m_page_size == p->m_page_size;
+        }
+        return false;
+    }
+
+
+    PMR_DECL std::size_t
+    mmap_resource::mapping_size(std::size_t bytes) const
+    {
+        if(std::numeric_limits<std::size_t>::max() - m_page_size < bytes)
+        {
+            throw std::bad_alloc();
+        }
+        return (bytes + m_page_size - 1) & ~(m_page_size - 1);
+    }
+}
+#endif
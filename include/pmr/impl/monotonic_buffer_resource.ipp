@@ -0,0 +1,247 @@
+#pragma once
+
+#include "pmr/monotonic_buffer_resource.h"
+#include "pmr/detail/config.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+namespace pmr
+{
+    namespace detail
+    {
+        enum monotonic_defaults : std::size_t
+        {
+            default_nextbuf_size = 32 * sizeof(void*)
+        };
+    }
+
+
+    PMR_DECL
+    monotonic_buffer_resource::monotonic_buffer_resource() noexcept
+        : monotonic_buffer_resource(detail::default_nextbuf_size, nullptr)
+    {
+    }
+
+
+    PMR_DECL
+    monotonic_buffer_resource::monotonic_buffer_resource(
+            memory_resource* upstream) noexcept
+        : monotonic_buffer_resource(detail::default_nextbuf_size, upstream)
+    {
+    }
+
+
+    PMR_DECL
+    monotonic_buffer_resource::monotonic_buffer_resource(
+            std::size_t initial_size) noexcept
+        : monotonic_buffer_resource(
+                std::max<std::size_t>(initial_size, detail::default_nextbuf_size), nullptr)
+    {
+    }
+
+
+    PMR_DECL
+    monotonic_buffer_resource::monotonic_buffer_resource(
+            std::size_t initial_size, memory_resource* upstream) noexcept
+        : m_upstream{upstream ? *upstream : *get_default_resource()}
+        , m_initialbuf{nullptr}
+        , m_initialbuf_size{0}
+        , m_currentbuf{nullptr}
+        , m_currentbuf_size{0}
+        , m_nextbuf_size{std::max<std::size_t>(initial_size, detail::default_nextbuf_size)}
+        , m_initial_nextbuf_size{m_nextbuf_size}
+        , m_allocated_bytes{0}
+        , m_padding_bytes{0}
+    {
+    }
+
+
+    PMR_DECL
+    monotonic_buffer_resource::monotonic_buffer_resource(
+            void* buf, std::size_t bufsize) noexcept
+        : monotonic_buffer_resource(buf, bufsize, nullptr)
+    {
+    }
+
+
+    PMR_DECL
+    monotonic_buffer_resource::monotonic_buffer_resource(
+            void* buf, std::size_t bufsize, memory_resource* upstream) noexcept
+        : m_upstream{upstream ? *upstream : *get_default_resource()}
+        , m_initialbuf{buf}
+        , m_initialbuf_size{bufsize}
+        , m_currentbuf{buf}
+        , m_currentbuf_size{bufsize}
+        , m_nextbuf_size{std::max<std::size_t>(bufsize, detail::default_nextbuf_size)}
+        , m_allocated_bytes{0}
+        , m_padding_bytes{0}
+    {
+        recalculate_next_buffer_size();
+        m_initial_nextbuf_size = m_nextbuf_size;
+    }
+
+
+    PMR_DECL
+    monotonic_buffer_resource::~monotonic_buffer_resource()
+    {
+        release();
+    }
+
+
+    PMR_DECL void
+    monotonic_buffer_resource::release()
+    {
+        m_blocks.release(m_upstream);
+        m_currentbuf = m_initialbuf;
+        m_currentbuf_size = m_initialbuf_size;
+        m_nextbuf_size = m_initial_nextbuf_size;
+        m_allocated_bytes = 0;
+        m_padding_bytes = 0;
+    }
+
+
+    PMR_DECL void
+    monotonic_buffer_resource::reset() noexcept
+    {
+        m_blocks.recycle();
+        m_currentbuf = m_initialbuf;
+        m_currentbuf_size = m_initialbuf_size;
+        m_allocated_bytes = 0;
+        m_padding_bytes = 0;
+    }
+
+
+    PMR_DECL monotonic_buffer_resource::checkpoint
+    monotonic_buffer_resource::mark() const noexcept
+    {
+        return {m_currentbuf, m_currentbuf_size, m_blocks.top(),
+            m_nextbuf_size, m_allocated_bytes, m_padding_bytes};
+    }
+
+
+    PMR_DECL void
+    monotonic_buffer_resource::rollback(const checkpoint& cp) noexcept
+    {
+        m_blocks.recycle(cp.blocks);
+        m_currentbuf = cp.buf;
+        m_currentbuf_size = cp.size;
+        m_allocated_bytes = cp.allocated;
+        m_padding_bytes = cp.padding;
+    }
+
+
+    PMR_DECL void
+    monotonic_buffer_resource::rollback_and_trim(const checkpoint& cp)
+    {
+        // block sizes grow with every request to upstream, so those
+        // obtained since the checkpoint are the ones at least as large as
+        // the next request it would have made
+        rollback(cp);
+        m_blocks.trim(cp.next, m_upstream);
+        m_nextbuf_size = cp.next;
+    }
+
+
+    PMR_DECL monotonic_buffer_resource::statistics
+    monotonic_buffer_resource::stats() const noexcept
+    {
+        return {m_allocated_bytes, m_padding_bytes, m_blocks.bytes(),
+            m_blocks.count()};
+    }
+
+
+    PMR_DECL memory_resource*
+    monotonic_buffer_resource::upstream_resource() const
+    {
+        return &m_upstream;
+    }
+
+
+    PMR_DECL void*
+    monotonic_buffer_resource::allocate_from_next_buffer(
+            std::size_t bytes, std::size_t align)
+    {
+        // prefer a block kept by reset() over asking upstream
+        std::size_t capacity = 0;
+        void* buf = m_blocks.reuse(bytes, align, capacity);
+        if(buf)
+        {
+            m_currentbuf = buf;
+            m_currentbuf_size = capacity;
+        }
+        else
+        {
+            // blocks start aligned for this request so need no padding
+            m_nextbuf_size = std::max(m_nextbuf_size, bytes);
+            m_currentbuf = m_blocks.extend(m_nextbuf_size, m_upstream,
+                    std::max(align, alignof(std::max_align_t)));
+            m_currentbuf_size = m_nextbuf_size;
+            recalculate_next_buffer_size();
+        }
+        std::size_t space = m_currentbuf_size;
+        void* allocated = std::align(align, bytes, m_currentbuf, m_currentbuf_size);
+        if(!allocated)
+        {
+            throw std::bad_alloc();
+        }
+        m_padding_bytes += space - m_currentbuf_size;
+        m_allocated_bytes += bytes;
+        m_currentbuf = reinterpret_cast<char*>(m_currentbuf) + bytes;
+        m_currentbuf_size -= bytes;
+        return allocated;
+    }
+
+
+    PMR_DECL allocation_result<void*>
+    monotonic_buffer_resource::do_allocate_at_least(
+            std::size_t bytes, std::size_t align)
+    {
+        void* allocated = do_allocate(bytes, align);
+
+        // hand over the tail of the current buffer when it is too small to
+        // satisfy another request of this size anyway
+        std::size_t usable = bytes;
+        if(m_currentbuf_size < bytes)
+        {
+            usable += m_currentbuf_size;
+            m_allocated_bytes += m_currentbuf_size;
+            m_currentbuf = reinterpret_cast<char*>(m_currentbuf) + m_currentbuf_size;
+            m_currentbuf_size = 0;
+        }
+        return {allocated, usable};
+    }
+
+
+    PMR_DECL void
+    monotonic_buffer_resource::do_allocate_bulk(void** out, std::size_t n,
+            std::size_t bytes, std::size_t align)
+    {
+        // one bump for the whole batch, each block padded to the alignment
+        std::size_t stride = (bytes + align - 1) & ~(align - 1);
+        if(stride < bytes || std::numeric_limits<std::size_t>::max() / n < stride)
+        {
+            throw std::bad_alloc();
+        }
+        char* first = static_cast<char*>(do_allocate(stride * n, align));
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            out[i] = first + i * stride;
+        }
+    }
+
+
+    PMR_DECL void
+    monotonic_buffer_resource::recalculate_next_buffer_size()
+    {
+        m_nextbuf_size = (std::size_t(-1)/2 < m_nextbuf_size)
+            ? std::size_t(-1) : m_currentbuf_size * 2;
+    }
+
+
+    PMR_DECL bool
+    monotonic_buffer_resource::do_is_equal(const memory_resource& other) const
+    {
+        return this == &other;
+    }
+}
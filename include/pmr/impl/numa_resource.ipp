@@ -0,0 +1,141 @@
+#pragma once
+
+#include "pmr/numa_resource.h"
+#include "pmr/detail/config.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef PMR_HAS_MMAP
+#if defined(__linux__)
+#   include <linux/mempolicy.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+namespace pmr
+{
+    namespace detail
+    {
+        PMR_DECL std::size_t read_node_count() noexcept
+        {
+            // the file holds a list of ranges such as "0-1,3"; the largest
+            // node number bounds the count
+            std::FILE* f = std::fopen("/sys/devices/system/node/online", "r");
+            if(!f)
+            {
+                return 1;
+            }
+            char buf[256] = {0};
+            std::size_t len = std::fread(buf, 1, sizeof(buf) - 1, f);
+            std::fclose(f);
+
+            long highest = 0;
+            for(char* p = buf; p < buf + len;)
+            {
+                char* end = p;
+                long n = std::strtol(p, &end, 10);
+                if(end == p)
+                {
+                    ++p;
+                    continue;
+                }
+                highest = n > highest ? n : highest;
+                p = end;
+            }
+            return static_cast<std::size_t>(highest) + 1;
+        }
+
+
+        PMR_DECL void bind_to_node(void* ptr, std::size_t length,
+                int node) noexcept
+        {
+#           if defined(__linux__) && defined(SYS_mbind)
+            const std::size_t bits = 8 * sizeof(unsigned long);
+            unsigned long mask[1024 / bits] = {0};
+            if(node < 0 || static_cast<std::size_t>(node) >= 1024)
+            {
+                return;
+            }
+            mask[node / bits] = 1UL << (node % bits);
+
+            // the kernel reads maxnode - 1 bits of the mask
+            ::syscall(SYS_mbind, ptr, length, MPOL_PREFERRED, mask,
+                    sizeof(mask) * 8 + 1, 0);
+#           else
+            (void)ptr;
+            (void)length;
+            (void)node;
+#           endif
+        }
+    }
+
+
+    PMR_DECL
+    numa_resource::numa_resource() noexcept
+        : numa_resource(local_node)
+    {
+    }
+
+
+    PMR_DECL
+    numa_resource::numa_resource(int node, page_mode mode) noexcept
+        : mmap_resource(mode)
+        , m_node{node}
+    {
+    }
+
+
+    PMR_DECL int
+    numa_resource::node() const noexcept
+    {
+        return m_node;
+    }
+
+
+    PMR_DECL std::size_t
+    numa_resource::node_count() noexcept
+    {
+        static const std::size_t count = detail::read_node_count();
+        return count;
+    }
+
+
+    PMR_DECL int
+    numa_resource::current_node() noexcept
+    {
+#       if defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu = 0;
+        unsigned node = 0;
+        if(0 == ::syscall(SYS_getcpu, &cpu, &node, nullptr))
+        {
+            return static_cast<int>(node);
+        }
+#       endif
+        return 0;
+    }
+
+
+    PMR_DECL void*
+    numa_resource::do_allocate(std::size_t bytes, std::size_t align)
+    {
+        return do_allocate_at_least(bytes, align).ptr;
+    }
+
+
+    PMR_DECL allocation_result<void*>
+    numa_resource::do_allocate_at_least(std::size_t bytes, std::size_t align)
+    {
+        allocation_result<void*> result =
+            mmap_resource::do_allocate_at_least(bytes, align);
+        if(node_count() > 1)
+        {
+            // pages are not populated until touched so binding after
+            // mapping still decides where they are placed
+            detail::bind_to_node(result.ptr, result.count,
+                    local_node == m_node ? current_node() : m_node);
+        }
+        return result;
+    }
+}
+#endif
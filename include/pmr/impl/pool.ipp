@@ -0,0 +1,203 @@
+#pragma once
+
+#include "pmr/detail/pool.h"
+#include "pmr/detail/config.h"
+#include "pmr/memory_resource.h"
+#include <algorithm>
+#include <new>
+
+namespace pmr
+{
+    namespace detail
+    {
+        enum pool_limits : std::size_t
+        {
+            default_max_blocks_per_chunk = 1024,
+            initial_chunk_size = 32 * sizeof(void*),
+            max_max_blocks_per_chunk = 1 << 20,
+            default_largest_required_pool_block = 4096,
+            max_largest_required_pool_block = 1 << 20
+        };
+
+
+        PMR_DECL pool_options
+        normalize(const pool_options& opts) noexcept
+        {
+            pool_options result = opts;
+            if(0 == result.max_blocks_per_chunk)
+            {
+                result.max_blocks_per_chunk = default_max_blocks_per_chunk;
+            }
+            result.max_blocks_per_chunk = std::min<std::size_t>(
+                    result.max_blocks_per_chunk, max_max_blocks_per_chunk);
+
+            if(0 == result.largest_required_pool_block)
+            {
+                result.largest_required_pool_block =
+                    default_largest_required_pool_block;
+            }
+            std::size_t largest = min_pool_block_size;
+            while(largest < result.largest_required_pool_block &&
+                    largest < max_largest_required_pool_block)
+            {
+                largest <<= 1;
+            }
+            result.largest_required_pool_block = largest;
+            return result;
+        }
+
+
+        PMR_DECL std::size_t
+        pool_count(const pool_options& opts) noexcept
+        {
+            return pool_index(opts.largest_required_pool_block) + 1;
+        }
+
+
+        PMR_DECL
+        pool::pool(std::size_t block_size,
+                std::size_t max_blocks_per_chunk) noexcept
+            : m_block_size{block_size}
+            , m_max_blocks_per_chunk{max_blocks_per_chunk}
+            , m_next_blocks_per_chunk{initial_blocks_per_chunk()}
+        {
+        }
+
+
+        PMR_DECL void*
+        pool::allocate(memory_resource& upstream)
+        {
+            if(m_free)
+            {
+                free_block* block = m_free;
+                m_free = block->next;
+                ++m_used;
+                return block;
+            }
+            if(m_next == m_end)
+            {
+                extend(upstream);
+            }
+            void* block = m_next;
+            m_next += m_block_size;
+            ++m_used;
+            return block;
+        }
+
+
+        PMR_DECL void
+        pool::allocate(void** out, std::size_t n, memory_resource& upstream)
+        {
+            std::size_t i = 0;
+            for(; i < n && m_free; ++i)
+            {
+                out[i] = m_free;
+                m_free = m_free->next;
+            }
+            try
+            {
+                while(i < n)
+                {
+                    if(m_next == m_end)
+                    {
+                        extend(upstream);
+                    }
+                    std::size_t carve = std::min<std::size_t>(n - i,
+                            (m_end - m_next) / m_block_size);
+                    for(; carve; --carve)
+                    {
+                        out[i++] = m_next;
+                        m_next += m_block_size;
+                    }
+                }
+            }
+            catch(...)
+            {
+                m_used += i;
+                deallocate(out, i);
+                throw;
+            }
+            m_used += n;
+        }
+
+
+        PMR_DECL void
+        pool::deallocate(void* ptr) noexcept
+        {
+            m_free = ::new (ptr) free_block{m_free};
+            --m_used;
+        }
+
+
+        PMR_DECL void
+        pool::deallocate(void* const* ptrs, std::size_t n) noexcept
+        {
+            // link the blocks in array order and splice the chain in once
+            free_block* head = m_free;
+            for(std::size_t i = n; i; --i)
+            {
+                head = ::new (ptrs[i - 1]) free_block{head};
+            }
+            m_free = head;
+            m_used -= n;
+        }
+
+
+        PMR_DECL void
+        pool::release(memory_resource& upstream)
+        {
+            m_chunks.release(upstream);
+            m_free = nullptr;
+            m_next = nullptr;
+            m_end = nullptr;
+            m_used = 0;
+            m_next_blocks_per_chunk = initial_blocks_per_chunk();
+        }
+
+
+        PMR_DECL std::size_t
+        pool::block_size() const noexcept
+        {
+            return m_block_size;
+        }
+
+
+        PMR_DECL pool_statistics
+        pool::stats() const noexcept
+        {
+            std::size_t blocks = m_chunks.bytes() / m_block_size;
+            return {m_block_size, m_chunks.count(), blocks, m_used,
+                blocks - m_used};
+        }
+
+
+        PMR_DECL std::size_t
+        pool::initial_blocks_per_chunk() const noexcept
+        {
+            std::size_t blocks =
+                m_block_size ? initial_chunk_size / m_block_size : 0;
+            return std::max<std::size_t>(1,
+                    std::min(blocks, m_max_blocks_per_chunk));
+        }
+
+
+        PMR_DECL void
+        pool::extend(memory_resource& upstream)
+        {
+            std::size_t chunk_size = m_block_size * m_next_blocks_per_chunk;
+            m_next = static_cast<char*>(m_chunks.extend(chunk_size, upstream,
+                        std::min<std::size_t>(m_block_size, max_pool_block_align)));
+            m_end = m_next + chunk_size;
+            recalculate_next_chunk_size();
+        }
+
+
+        PMR_DECL void
+        pool::recalculate_next_chunk_size() noexcept
+        {
+            m_next_blocks_per_chunk =
+                (m_max_blocks_per_chunk / 2 < m_next_blocks_per_chunk)
+                ? m_max_blocks_per_chunk : m_next_blocks_per_chunk * 2;
+        }
+    }
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "pmr/recording_resource.h"
+#include "pmr/detail/config.h"
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace pmr
+{
+    namespace detail
+    {
+        inline const char* trace_magic() noexcept
+        {
+            return "PMRTRACE";
+        }
+
+        enum trace_format : std::size_t
+        {
+            trace_version = 2,
+            trace_buffer_events = 4096
+        };
+    }
+
+
+    PMR_DECL
+    recording_resource::recording_resource(
+            const char* path, memory_resource* upstream)
+        : m_upstream{upstream ? *upstream : *get_default_resource()}
+        , m_file{std::fopen(path, "wb")}
+        , m_start{std::chrono::steady_clock::now()}
+        , m_next_id{0}
+        , m_events{0}
+        , m_write_error{0}
+    {
+        if(!m_file)
+        {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        trace_header header;
+        std::memcpy(header.magic, detail::trace_magic(), sizeof(header.magic));
+        header.version = detail::trace_version;
+        header.event_size = sizeof(trace_event);
+        if(1 != std::fwrite(&header, sizeof(header), 1, m_file))
+        {
+            int error = errno;
+            std::fclose(m_file);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+        m_buffer.reserve(detail::trace_buffer_events);
+    }
+
+
+    PMR_DECL
+    recording_resource::~recording_resource()
+    {
+        try
+        {
+            flush();
+        }
+        catch(const std::system_error&)
+        {
+            // a destructor has nobody to report a failed write to
+        }
+        std::fclose(m_file);
+    }
+
+
+    PMR_DECL void
+    recording_resource::flush()
+    {
+        std::lock_guard<std::mutex> guard{m_lock};
+        write_buffer();
+        if(0 != std::fflush(m_file) && 0 == m_write_error)
+        {
+            m_write_error = errno;
+        }
+        if(0 != m_write_error)
+        {
+            throw std::system_error(m_write_error, std::generic_category());
+        }
+    }
+
+
+    PMR_DECL std::uint64_t
+    recording_resource::events() const
+    {
+        std::lock_guard<std::mutex> guard{m_lock};
+        return m_events;
+    }
+
+
+    PMR_DECL memory_resource*
+    recording_resource::upstream_resource() const
+    {
+        return &m_upstream;
+    }
+
+
+    PMR_DECL void*
+    recording_resource::do_allocate(std::size_t bytes, std::size_t align)
+    {
+        void* ptr = m_upstream.allocate(bytes, align);
+        std::lock_guard<std::mutex> guard{m_lock};
+        std::uint64_t id = m_next_id++;
+        try
+        {
+            m_ids[ptr] = id;
+            record(trace_event::allocate, id, bytes, align);
+        }
+        catch(...)
+        {
+            m_ids.erase(ptr);
+            m_upstream.deallocate(ptr, bytes, align);
+            throw;
+        }
+        return ptr;
+    }
+
+
+    PMR_DECL void
+    recording_resource::do_deallocate(
+            void* ptr, std::size_t bytes, std::size_t align)
+    {
+        {
+            std::lock_guard<std::mutex> guard{m_lock};
+            std::uint64_t id = trace_event::unknown_id;
+            auto it = m_ids.find(ptr);
+            if(it != m_ids.end())
+            {
+                id = it->second;
+                m_ids.erase(it);
+            }
+            try
+            {
+                record(trace_event::deallocate, id, bytes, align);
+            }
+            catch(const std::bad_alloc&)
+            {
+                // losing a record beats leaking the block
+            }
+        }
+        m_upstream.deallocate(ptr, bytes, align);
+    }
+
+
+    PMR_DECL bool
+    recording_resource::do_is_equal(const memory_resource& other) const
+    {
+        return this == &other;
+    }
+
+
+    PMR_DECL void
+    recording_resource::record(trace_event::kind op, std::uint64_t id,
+            std::size_t bytes, std::size_t align)
+    {
+        auto thread = m_threads.emplace(std::this_thread::get_id(),
+                static_cast<std::uint32_t>(m_threads.size())).first->second;
+
+        trace_event e;
+        e.timestamp = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - m_start).count());
+        e.id = id;
+        e.bytes = bytes;
+        e.align = static_cast<std::uint32_t>(align);
+        e.thread = thread;
+        e.op = op;
+        std::memset(e.reserved, 0, sizeof(e.reserved));
+        m_buffer.push_back(e);
+        ++m_events;
+        if(m_buffer.size() == detail::trace_buffer_events)
+        {
+            write_buffer();
+        }
+    }
+
+
+    PMR_DECL void
+    recording_resource::write_buffer()
+    {
+        std::size_t n = m_buffer.size();
+        std::size_t written =
+            std::fwrite(m_buffer.data(), sizeof(trace_event), n, m_file);
+        m_buffer.clear();
+
+        // reported by flush() rather than failing the allocation at hand
+        if(n != written && 0 == m_write_error)
+        {
+            m_write_error = errno;
+        }
+    }
+
+
+    PMR_DECL std::vector<trace_event>
+    read_trace(const char* path)
+    {
+        std::FILE* f = std::fopen(path, "rb");
+        if(!f)
+        {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> closer{f, std::fclose};
+
+        trace_header header;
+        if(1 != std::fread(&header, sizeof(header), 1, f)
+                || 0 != std::memcmp(header.magic, detail::trace_magic(),
+                    sizeof(header.magic))
+                || detail::trace_version != header.version
+                || sizeof(trace_event) != header.event_size)
+        {
+            throw std::runtime_error(std::string{path} + ": not a version "
+                    + std::to_string(detail::trace_version) + " pmr trace");
+        }
+
+        std::vector<trace_event> events;
+        trace_event buf[1024];
+        std::size_t n = 0;
+        while(0 != (n = std::fread(buf, sizeof(trace_event), 1024, f)))
+        {
+            events.insert(events.end(), buf, buf + n);
+        }
+        if(std::ferror(f))
+        {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        return events;
+    }
+}
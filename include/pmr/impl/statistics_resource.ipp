@@ -0,0 +1,173 @@
+#pragma once
+
+#include "pmr/statistics_resource.h"
+#include "pmr/detail/config.h"
+#include "pmr/detail/thread_slots.h"
+#include <algorithm>
+
+namespace pmr
+{
+    namespace detail
+    {
+        // adds to a counter only the calling thread writes
+        template <typename T>
+        void bump(std::atomic<T>& counter, T n) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + n,
+                    std::memory_order_relaxed);
+        }
+    }
+
+
+    PMR_DECL
+    statistics_resource::statistics_resource(memory_resource* upstream)
+        : m_upstream{upstream ? *upstream : *get_default_resource()}
+        , m_id{detail::next_shard_id().fetch_add(
+                    1, std::memory_order_relaxed)}
+        , m_in_use{0}
+        , m_peak{0}
+    {
+    }
+
+
+    PMR_DECL statistics_resource::statistics
+    statistics_resource::stats() const noexcept
+    {
+        statistics result{};
+        result.bytes_in_use = m_in_use.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> guard{m_shards_lock};
+        result.threads = m_shards.size();
+        for(const std::unique_ptr<shard>& sp : m_shards)
+        {
+            const shard& s = *sp;
+            for(std::size_t b = 0; b < size_buckets; ++b)
+            {
+                std::uint64_t n = s.sizes[b].load(std::memory_order_relaxed);
+                result.sizes[b] += n;
+                result.allocations += n;
+            }
+            for(std::size_t b = 0; b < align_buckets; ++b)
+            {
+                result.alignments[b] +=
+                    s.alignments[b].load(std::memory_order_relaxed);
+            }
+            result.deallocations +=
+                s.deallocations.load(std::memory_order_relaxed);
+            result.failed_allocations +=
+                s.failures.load(std::memory_order_relaxed);
+            result.bytes_in_use += s.pending.load(std::memory_order_relaxed);
+        }
+        result.peak_bytes_in_use = std::max(result.bytes_in_use,
+                m_peak.load(std::memory_order_relaxed));
+        return result;
+    }
+
+
+    PMR_DECL memory_resource*
+    statistics_resource::upstream_resource() const
+    {
+        return &m_upstream;
+    }
+
+
+    PMR_DECL void*
+    statistics_resource::do_allocate(std::size_t bytes, std::size_t align)
+    {
+        shard& s = local_shard();
+        void* ptr;
+        try
+        {
+            ptr = m_upstream.allocate(bytes, align);
+        }
+        catch(...)
+        {
+            detail::bump<std::uint64_t>(s.failures, 1);
+            throw;
+        }
+        detail::bump<std::uint64_t>(s.sizes[size_bucket(bytes)], 1);
+        detail::bump<std::uint64_t>(s.alignments[align_bucket(align)], 1);
+        add_bytes(s, static_cast<std::int64_t>(bytes));
+        return ptr;
+    }
+
+
+    PMR_DECL void
+    statistics_resource::do_deallocate(
+            void* ptr, std::size_t bytes, std::size_t align)
+    {
+        m_upstream.deallocate(ptr, bytes, align);
+        shard& s = local_shard();
+        detail::bump<std::uint64_t>(s.deallocations, 1);
+        add_bytes(s, -static_cast<std::int64_t>(bytes));
+    }
+
+
+    PMR_DECL bool
+    statistics_resource::do_is_equal(const memory_resource& other) const
+    {
+        return this == &other;
+    }
+
+
+    PMR_DECL statistics_resource::shard&
+    statistics_resource::local_shard()
+    {
+        const detail::shard_slot& slot = detail::shard_slot_for(m_id);
+        if(slot.id == m_id)
+        {
+            return *static_cast<shard*>(slot.shard);
+        }
+        return register_shard();
+    }
+
+
+    PMR_DECL statistics_resource::shard&
+    statistics_resource::register_shard()
+    {
+        // evicted from the thread's slots by another resource
+        std::thread::id self = std::this_thread::get_id();
+        shard* result = static_cast<shard*>(m_shards_by_thread.find(self));
+        if(!result)
+        {
+            std::unique_ptr<shard> s{new shard()};
+            result = s.get();
+            std::lock_guard<std::mutex> guard{m_shards_lock};
+            m_shards.push_back(std::move(s));
+            m_shards_by_thread.insert(self, result);
+        }
+        detail::shard_slot_for(m_id) = detail::shard_slot{m_id, result};
+        return *result;
+    }
+
+
+    PMR_DECL void
+    statistics_resource::add_bytes(shard& s, std::int64_t bytes) noexcept
+    {
+        const std::int64_t limit = fold_bytes;
+        std::int64_t pending =
+            s.pending.load(std::memory_order_relaxed) + bytes;
+        s.pending.store(pending, std::memory_order_relaxed);
+        std::int64_t in_use;
+        if(pending < limit && pending > -limit)
+        {
+            if(bytes < 0)
+            {
+                return;
+            }
+            // only reads shared lines unless this is a new peak
+            in_use = m_in_use.load(std::memory_order_relaxed) + pending;
+        }
+        else
+        {
+            s.pending.store(0, std::memory_order_relaxed);
+            in_use = m_in_use.fetch_add(pending, std::memory_order_relaxed)
+                + pending;
+        }
+
+        std::int64_t peak = m_peak.load(std::memory_order_relaxed);
+        while(in_use > peak && !m_peak.compare_exchange_weak(
+                    peak, in_use, std::memory_order_relaxed))
+        {
+        }
+    }
+}
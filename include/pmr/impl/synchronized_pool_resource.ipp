@@ -0,0 +1,686 @@
+#pragma once
+
+#include "pmr/synchronized_pool_resource.h"
+#include "pmr/detail/config.h"
+#include "pmr/detail/batch_stack.h"
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <vector>
+
+namespace pmr
+{
+    namespace detail
+    {
+        //! A count written only by one thread that others may read
+        class owned_count
+        {
+          public:
+            owned_count(std::size_t n = 0) noexcept
+                : m_value{n}
+            {
+            }
+
+            operator std::size_t() const noexcept
+            {
+                return m_value.load(std::memory_order_relaxed);
+            }
+
+            owned_count& operator=(std::size_t n) noexcept
+            {
+                m_value.store(n, std::memory_order_relaxed);
+                return *this;
+            }
+
+            owned_count& operator+=(std::size_t n) noexcept
+            {
+                return *this = *this + n;
+            }
+
+            owned_count& operator++() noexcept
+            {
+                return *this += 1;
+            }
+
+            owned_count& operator--() noexcept
+            {
+                return *this = *this - 1;
+            }
+
+          private:
+            std::atomic<std::size_t> m_value;
+        };
+
+
+        //! The free blocks cached by one thread for one
+        //! synchronized_pool_resource. Owned jointly by the thread and the
+        //! resource so that either may go away first.
+        struct thread_cache
+        {
+            // a line each so that other threads' caches never share one
+            struct alignas(cache_line_size) magazine
+            {
+                batch_node* head = nullptr;
+                owned_count count;
+                std::size_t batch = 1; // blocks moved per refill/flush
+            };
+
+            thread_cache(synchronized_pool_resource* o, std::size_t npools)
+                : owner{o}
+                , magazines{npools}
+            {
+            }
+
+            void unref()
+            {
+                if(1 == refs.fetch_sub(1, std::memory_order_acq_rel))
+                {
+                    delete this;
+                }
+            }
+
+            void thread_exit()
+            {
+                {
+                    std::lock_guard<std::mutex> guard{lock};
+                    if(owner)
+                    {
+                        owner->flush(*this);
+                        owner = nullptr;
+                    }
+                }
+                unref();
+            }
+
+            // guards owner and access to magazines from other threads
+            std::mutex lock;
+            synchronized_pool_resource* owner;
+            std::atomic<int> refs{2}; // owning thread + owner's registry
+            thread_cache* next = nullptr; // guarded by owner's m_caches_lock
+            cache_aligned_array<magazine> magazines;
+        };
+    }
+
+
+    //! Free blocks are exchanged with thread caches a batch at a time
+    //! through a lock-free stack. The lock is only taken to carve new
+    //! blocks out of pool chunks. The stack and the pool each get a line
+    //! to themselves, apart from those of neighbouring pools.
+    struct alignas(detail::cache_line_size)
+    synchronized_pool_resource::central_pool
+    {
+        central_pool()
+            : pool{0, 0}
+        {
+        }
+
+        detail::batch_stack batches;
+        std::atomic<std::size_t> batched{0}; // blocks on batches
+        alignas(detail::cache_line_size) std::mutex lock;
+        detail::pool pool;
+    };
+
+
+    namespace detail
+    {
+        // blocks moved between a thread cache and the shared pool at once
+        enum batch_limits : std::size_t
+        {
+            max_batch = 32,
+            batch_bytes = 4096
+        };
+
+        struct cache_entry
+        {
+            std::uint64_t id;
+            thread_cache* cache;
+        };
+
+        // The state below is function-local so that header-only builds
+        // share one instance across translation units
+
+        inline std::atomic<std::uint64_t>& next_resource_id() noexcept
+        {
+            static std::atomic<std::uint64_t> id{1};
+            return id;
+        }
+
+
+        // trivially destructible so access needs no initialization guard
+        inline cache_entry& last_cache() noexcept
+        {
+            static thread_local cache_entry t_last{0, nullptr};
+            return t_last;
+        }
+
+
+        inline bool& thread_exited() noexcept
+        {
+            static thread_local bool t_exited = false;
+            return t_exited;
+        }
+
+
+        struct cache_table
+        {
+            ~cache_table()
+            {
+                last_cache() = cache_entry{0, nullptr};
+                thread_exited() = true;
+                for(cache_entry& entry : entries)
+                {
+                    entry.cache->thread_exit();
+                }
+            }
+
+            std::vector<cache_entry> entries;
+        };
+
+
+        inline cache_table& thread_caches()
+        {
+            static thread_local cache_table t_caches;
+            return t_caches;
+        }
+
+
+        inline bool orphaned(thread_cache& cache)
+        {
+            std::lock_guard<std::mutex> guard{cache.lock};
+            return !cache.owner;
+        }
+    }
+
+
+    PMR_DECL
+    synchronized_pool_resource::synchronized_pool_resource()
+        : synchronized_pool_resource(pool_options{}, nullptr)
+    {
+    }
+
+
+    PMR_DECL
+    synchronized_pool_resource::synchronized_pool_resource(
+            memory_resource* upstream)
+        : synchronized_pool_resource(pool_options{}, upstream)
+    {
+    }
+
+
+    PMR_DECL
+    synchronized_pool_resource::synchronized_pool_resource(
+            const pool_options& opts, memory_resource* upstream)
+        : m_opts{opts}
+        , m_upstream{upstream ? upstream : get_default_resource()}
+        , m_id{detail::next_resource_id().fetch_add(
+                    1, std::memory_order_relaxed)}
+        , m_pool_count{0}
+    {
+        adjust_pool_options();
+        init_pools();
+    }
+
+
+    PMR_DECL
+    synchronized_pool_resource::~synchronized_pool_resource()
+    {
+        {
+            std::lock_guard<std::mutex> guard{m_caches_lock};
+            while(m_caches)
+            {
+                detail::thread_cache* cache = m_caches;
+                m_caches = cache->next;
+                {
+                    std::lock_guard<std::mutex> cache_guard{cache->lock};
+                    cache->owner = nullptr;
+                }
+                cache->unref();
+            }
+        }
+        release();
+    }
+
+
+    PMR_DECL void
+    synchronized_pool_resource::release()
+    {
+        {
+            std::lock_guard<std::mutex> guard{m_caches_lock};
+            for(detail::thread_cache* cache = m_caches; cache;
+                    cache = cache->next)
+            {
+                std::lock_guard<std::mutex> cache_guard{cache->lock};
+                for(std::size_t i = 0; i < m_pool_count; ++i)
+                {
+                    cache->magazines[i].head = nullptr;
+                    cache->magazines[i].count = 0;
+                }
+            }
+        }
+        for(std::size_t i = 0; i < m_pool_count; ++i)
+        {
+            std::lock_guard<std::mutex> guard{m_pools[i].lock};
+            m_pools[i].batches.clear();
+            m_pools[i].batched.store(0, std::memory_order_relaxed);
+            m_pools[i].pool.release(*m_upstream);
+        }
+        std::lock_guard<std::mutex> guard{m_oversized_lock};
+        m_oversized.release(*m_upstream);
+    }
+
+
+    PMR_DECL memory_resource*
+    synchronized_pool_resource::upstream_resource() const
+    {
+        return m_upstream;
+    }
+
+
+    PMR_DECL pool_options
+    synchronized_pool_resource::options() const
+    {
+        return m_opts;
+    }
+
+
+    PMR_DECL pool_resource_statistics
+    synchronized_pool_resource::stats() const
+    {
+        pool_resource_statistics result;
+        result.pools.reserve(m_pool_count);
+        std::vector<std::size_t> cached(m_pool_count, 0);
+        {
+            std::lock_guard<std::mutex> guard{m_caches_lock};
+            for(detail::thread_cache* cache = m_caches; cache;
+                    cache = cache->next)
+            {
+                for(std::size_t i = 0; i < m_pool_count; ++i)
+                {
+                    cached[i] += cache->magazines[i].count;
+                }
+            }
+        }
+        for(std::size_t i = 0; i < m_pool_count; ++i)
+        {
+            central_pool& central = m_pools[i];
+            pool_statistics s;
+            {
+                std::lock_guard<std::mutex> guard{central.lock};
+                s = central.pool.stats();
+            }
+            // blocks on the shared stack or in thread caches are free
+            std::size_t idle = cached[i]
+                + central.batched.load(std::memory_order_relaxed);
+            s.used_blocks = s.used_blocks > idle ? s.used_blocks - idle : 0;
+            s.free_blocks = s.blocks - s.used_blocks;
+            result.pools.push_back(s);
+        }
+        std::lock_guard<std::mutex> guard{m_oversized_lock};
+        result.oversized_blocks = m_oversized.top();
+        result.oversized_bytes = m_oversized.bytes();
+        return result;
+    }
+
+
+    PMR_DECL void*
+    synchronized_pool_resource::do_allocate(
+            std::size_t bytes, std::size_t align)
+    {
+        std::size_t index = which_pool(bytes, align);
+        if(index == m_pool_count)
+        {
+            std::lock_guard<std::mutex> guard{m_oversized_lock};
+            return m_oversized.extend(bytes, *m_upstream, align);
+        }
+
+        detail::thread_cache* cache = local_cache();
+        if(!cache)
+        {
+            central_pool& central = m_pools[index];
+            if(detail::batch_node* batch = central.batches.pop())
+            {
+                central.batched.fetch_sub(1, std::memory_order_relaxed);
+                if(batch->next)
+                {
+                    central.batches.push(::new (batch->next)
+                            detail::batch_node{batch->next->next});
+                }
+                return batch;
+            }
+            std::lock_guard<std::mutex> guard{central.lock};
+            return central.pool.allocate(*m_upstream);
+        }
+
+        detail::thread_cache::magazine& mag = cache->magazines[index];
+        if(!mag.head)
+        {
+            refill(*cache, index);
+        }
+        detail::batch_node* block = mag.head;
+        mag.head = block->next;
+        --mag.count;
+        return block;
+    }
+
+
+    PMR_DECL allocation_result<void*>
+    synchronized_pool_resource::do_allocate_at_least(
+            std::size_t bytes, std::size_t align)
+    {
+        std::size_t index = which_pool(bytes, align);
+        void* allocated = do_allocate(bytes, align);
+        if(index == m_pool_count)
+        {
+            return {allocated, bytes};
+        }
+        return {allocated, detail::min_pool_block_size << index};
+    }
+
+
+    PMR_DECL void
+    synchronized_pool_resource::do_deallocate(
+            void* ptr, std::size_t bytes, std::size_t align)
+    {
+        std::size_t index = which_pool(bytes, align);
+        if(index == m_pool_count)
+        {
+            std::lock_guard<std::mutex> guard{m_oversized_lock};
+            return m_oversized.deallocate(ptr, bytes, *m_upstream);
+        }
+
+        detail::thread_cache* cache = local_cache();
+        if(!cache)
+        {
+            m_pools[index].batched.fetch_add(1, std::memory_order_relaxed);
+            return m_pools[index].batches.push(
+                    ::new (ptr) detail::batch_node{nullptr});
+        }
+
+        detail::thread_cache::magazine& mag = cache->magazines[index];
+        mag.head = ::new (ptr) detail::batch_node{mag.head};
+        ++mag.count;
+        while(mag.count >= 2 * mag.batch)
+        {
+            flush(*cache, index, mag.batch);
+        }
+    }
+
+
+    PMR_DECL void
+    synchronized_pool_resource::do_allocate_bulk(void** out, std::size_t n,
+            std::size_t bytes, std::size_t align)
+    {
+        std::size_t index = which_pool(bytes, align);
+        detail::thread_cache* cache =
+            index == m_pool_count ? nullptr : local_cache();
+        if(!cache)
+        {
+            return memory_resource::do_allocate_bulk(out, n, bytes, align);
+        }
+
+        detail::thread_cache::magazine& mag = cache->magazines[index];
+        std::size_t i = 0;
+        try
+        {
+            for(; i < n; ++i)
+            {
+                if(!mag.head)
+                {
+                    refill(*cache, index);
+                }
+                out[i] = mag.head;
+                mag.head = mag.head->next;
+                --mag.count;
+            }
+        }
+        catch(...)
+        {
+            do_deallocate_bulk(out, i, bytes, align);
+            throw;
+        }
+    }
+
+
+    PMR_DECL void
+    synchronized_pool_resource::do_deallocate_bulk(void* const* ptrs,
+            std::size_t n, std::size_t bytes, std::size_t align)
+    {
+        std::size_t index = which_pool(bytes, align);
+        detail::thread_cache* cache =
+            index == m_pool_count ? nullptr : local_cache();
+        if(!cache)
+        {
+            return memory_resource::do_deallocate_bulk(ptrs, n, bytes, align);
+        }
+
+        detail::thread_cache::magazine& mag = cache->magazines[index];
+        if(n < mag.batch)
+        {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                mag.head = ::new (ptrs[i]) detail::batch_node{mag.head};
+            }
+            mag.count += n;
+            while(mag.count >= 2 * mag.batch)
+            {
+                flush(*cache, index, mag.batch);
+            }
+            return;
+        }
+
+        // at least a batch worth; hand it straight to the shared pool
+        detail::batch_node* head = nullptr;
+        for(std::size_t i = n; i; --i)
+        {
+            head = ::new (ptrs[i - 1]) detail::batch_node{head};
+        }
+        m_pools[index].batched.fetch_add(n, std::memory_order_relaxed);
+        m_pools[index].batches.push(head);
+    }
+
+
+    PMR_DECL bool
+    synchronized_pool_resource::do_is_equal(
+            const memory_resource& other) const
+    {
+        return this == &other;
+    }
+
+
+    PMR_DECL void
+    synchronized_pool_resource::adjust_pool_options()
+    {
+        m_opts = detail::normalize(m_opts);
+    }
+
+
+    PMR_DECL void
+    synchronized_pool_resource::init_pools()
+    {
+        m_pool_count = detail::pool_count(m_opts);
+        m_pools = detail::cache_aligned_array<central_pool>{m_pool_count};
+        for(std::size_t i = 0; i < m_pool_count; ++i)
+        {
+            m_pools[i].pool = detail::pool{detail::min_pool_block_size << i,
+                m_opts.max_blocks_per_chunk};
+        }
+    }
+
+
+    PMR_DECL std::size_t
+    synchronized_pool_resource::which_pool(
+            std::size_t bytes, std::size_t align) const
+    {
+        std::size_t size = std::max(bytes, align);
+        if(size > m_opts.largest_required_pool_block ||
+                align > detail::max_pool_block_align)
+        {
+            return m_pool_count;
+        }
+        return detail::pool_index(size);
+    }
+
+
+    PMR_DECL detail::thread_cache*
+    synchronized_pool_resource::local_cache()
+    {
+        const detail::cache_entry& last = detail::last_cache();
+        if(last.id == m_id)
+        {
+            return last.cache;
+        }
+        return register_cache();
+    }
+
+
+    PMR_DECL detail::thread_cache*
+    synchronized_pool_resource::register_cache()
+    {
+        if(detail::thread_exited())
+        {
+            // thread is shutting down; go straight to the shared pools
+            return nullptr;
+        }
+
+        std::vector<detail::cache_entry>& entries =
+            detail::thread_caches().entries;
+        for(detail::cache_entry& entry : entries)
+        {
+            if(entry.id == m_id)
+            {
+                detail::last_cache() = entry;
+                return entry.cache;
+            }
+        }
+
+        // forget caches belonging to resources that no longer exist
+        auto dead = std::remove_if(begin(entries), end(entries),
+                [](detail::cache_entry& entry) {
+                    return detail::orphaned(*entry.cache);
+                });
+        std::for_each(dead, end(entries),
+                [](detail::cache_entry& entry) { entry.cache->unref(); });
+        entries.erase(dead, end(entries));
+        entries.reserve(entries.size() + 1);
+
+        detail::thread_cache* cache =
+            new detail::thread_cache{this, m_pool_count};
+        for(std::size_t i = 0; i < m_pool_count; ++i)
+        {
+            std::size_t block_size = m_pools[i].pool.block_size();
+            cache->magazines[i].batch = std::max<std::size_t>(1,
+                    std::min<std::size_t>(detail::max_batch,
+                        detail::batch_bytes / block_size));
+        }
+        {
+            std::lock_guard<std::mutex> guard{m_caches_lock};
+
+            // drop caches of threads that have exited
+            detail::thread_cache** link = &m_caches;
+            while(*link)
+            {
+                detail::thread_cache* other = *link;
+                if(detail::orphaned(*other))
+                {
+                    *link = other->next;
+                    other->unref();
+                }
+                else
+                {
+                    link = &other->next;
+                }
+            }
+            cache->next = m_caches;
+            m_caches = cache;
+        }
+        entries.push_back(detail::cache_entry{m_id, cache});
+        detail::last_cache() = entries.back();
+        return cache;
+    }
+
+
+    PMR_DECL void
+    synchronized_pool_resource::refill(
+            detail::thread_cache& cache, std::size_t index)
+    {
+        detail::thread_cache::magazine& mag = cache.magazines[index];
+        central_pool& central = m_pools[index];
+        if(detail::batch_node* batch = central.batches.pop())
+        {
+            // batches from deallocate_bulk may be any length; take no more
+            // than a magazine's and leave the rest for other threads
+            detail::batch_node* last = batch;
+            std::size_t n = 1;
+            for(; n < mag.batch && last->next; ++n)
+            {
+                last = last->next;
+            }
+            if(detail::batch_node* rest = last->next)
+            {
+                last->next = nullptr;
+                central.batches.push(::new (rest)
+                        detail::batch_node{rest->next});
+            }
+            central.batched.fetch_sub(n, std::memory_order_relaxed);
+            mag.head = batch;
+            mag.count += n;
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard{central.lock};
+        for(std::size_t i = 0; i < mag.batch; ++i)
+        {
+            void* block;
+            try
+            {
+                block = central.pool.allocate(*m_upstream);
+            }
+            catch(...)
+            {
+                if(mag.head)
+                {
+                    return;
+                }
+                throw;
+            }
+            mag.head = ::new (block) detail::batch_node{mag.head};
+            ++mag.count;
+        }
+    }
+
+
+    PMR_DECL void
+    synchronized_pool_resource::flush(
+            detail::thread_cache& cache, std::size_t index, std::size_t count)
+    {
+        detail::thread_cache::magazine& mag = cache.magazines[index];
+        if(!count || !mag.head)
+        {
+            return;
+        }
+
+        // detach the first count blocks and hand them over as one batch
+        detail::batch_node* first = mag.head;
+        detail::batch_node* last = first;
+        std::size_t n = 1;
+        for(; n < count && last->next; ++n)
+        {
+            last = last->next;
+        }
+        mag.head = last->next;
+        last->next = nullptr;
+        mag.count = mag.head ? mag.count - n : 0;
+        m_pools[index].batched.fetch_add(n, std::memory_order_relaxed);
+        m_pools[index].batches.push(first);
+    }
+
+
+    PMR_DECL void
+    synchronized_pool_resource::flush(detail::thread_cache& cache)
+    {
+        for(std::size_t i = 0; i < m_pool_count; ++i)
+        {
+            flush(cache, i, cache.magazines[i].count);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "pmr/thread_arena_resource.h"
+#include "pmr/resource_allocator.h"
+#include "pmr/detail/config.h"
+#include "pmr/detail/thread_slots.h"
+#include <utility>
+
+namespace pmr
+{
+    PMR_DECL
+    thread_arena_resource::thread_arena_resource()
+        : thread_arena_resource(0, nullptr)
+    {
+    }
+
+
+    PMR_DECL
+    thread_arena_resource::thread_arena_resource(memory_resource* upstream)
+        : thread_arena_resource(0, upstream)
+    {
+    }
+
+
+    PMR_DECL
+    thread_arena_resource::thread_arena_resource(
+            std::size_t initial_size, memory_resource* upstream)
+        : m_upstream{upstream ? *upstream : *get_default_resource()}
+        , m_initial_size{initial_size}
+        , m_id{detail::next_shard_id().fetch_add(
+                    1, std::memory_order_relaxed)}
+    {
+    }
+
+
+    PMR_DECL
+    thread_arena_resource::~thread_arena_resource()
+    {
+        release();
+    }
+
+
+    PMR_DECL void
+    thread_arena_resource::release()
+    {
+        // arenas outlive release() as threads may still hold them in
+        // their slots
+        std::lock_guard<std::mutex> guard{m_arenas_lock};
+        for(std::unique_ptr<arena>& a : m_arenas)
+        {
+            a->mbr.release();
+        }
+    }
+
+
+    PMR_DECL std::size_t
+    thread_arena_resource::arenas() const
+    {
+        std::lock_guard<std::mutex> guard{m_arenas_lock};
+        return m_arenas.size();
+    }
+
+
+    PMR_DECL memory_resource*
+    thread_arena_resource::upstream_resource() const
+    {
+        return &m_upstream;
+    }
+
+
+    PMR_DECL void*
+    thread_arena_resource::do_allocate(std::size_t bytes, std::size_t align)
+    {
+        return detail::resource_access::allocate(local_arena(), bytes, align);
+    }
+
+
+    PMR_DECL allocation_result<void*>
+    thread_arena_resource::do_allocate_at_least(
+            std::size_t bytes, std::size_t align)
+    {
+        return local_arena().allocate_at_least(bytes, align);
+    }
+
+
+    PMR_DECL void
+    thread_arena_resource::do_allocate_bulk(void** out, std::size_t n,
+            std::size_t bytes, std::size_t align)
+    {
+        local_arena().allocate_bulk(out, n, bytes, align);
+    }
+
+
+    PMR_DECL bool
+    thread_arena_resource::do_is_equal(const memory_resource& other) const
+    {
+        return this == &other;
+    }
+
+
+    PMR_DECL monotonic_buffer_resource&
+    thread_arena_resource::local_arena()
+    {
+        const detail::shard_slot& slot = detail::shard_slot_for(m_id);
+        if(slot.id == m_id)
+        {
+            return static_cast<arena*>(slot.shard)->mbr;
+        }
+        return register_arena();
+    }
+
+
+    PMR_DECL monotonic_buffer_resource&
+    thread_arena_resource::register_arena()
+    {
+        // evicted from the thread's slots by another resource
+        std::thread::id self = std::this_thread::get_id();
+        arena* result = static_cast<arena*>(m_arenas_by_thread.find(self));
+        if(!result)
+        {
+            std::unique_ptr<arena> a{new arena{m_initial_size, &m_upstream}};
+            result = a.get();
+            std::lock_guard<std::mutex> guard{m_arenas_lock};
+            m_arenas.push_back(std::move(a));
+            m_arenas_by_thread.insert(self, result);
+        }
+        detail::shard_slot_for(m_id) = detail::shard_slot{m_id, result};
+        return result->mbr;
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "pmr/unsynchronized_pool_resource.h"
+#include "pmr/detail/config.h"
+#include <algorithm>
+
+namespace pmr
+{
+    PMR_DECL
+    unsynchronized_pool_resource::unsynchronized_pool_resource()
+        : unsynchronized_pool_resource(pool_options{}, nullptr)
+    {
+    }
+
+
+    PMR_DECL
+    unsynchronized_pool_resource::unsynchronized_pool_resource(
+            memory_resource* upstream)
+        : unsynchronized_pool_resource(pool_options{}, upstream)
+    {
+    }
+
+
+    PMR_DECL
+    unsynchronized_pool_resource::unsynchronized_pool_resource(
+            const pool_options& opts, memory_resource* upstream)
+        : m_opts{opts}
+        , m_upstream{upstream ? *upstream : *get_default_resource()}
+        , m_pools{&m_upstream}
+    {
+        adjust_pool_options();
+        init_pools();
+    }
+
+
+    PMR_DECL
+    unsynchronized_pool_resource::~unsynchronized_pool_resource()
+    {
+        release();
+    }
+
+
+    PMR_DECL void
+    unsynchronized_pool_resource::release()
+    {
+        for(detail::pool& p : m_pools)
+        {
+            p.release(m_upstream);
+        }
+        m_oversized.release(m_upstream);
+    }
+
+
+    PMR_DECL memory_resource*
+    unsynchronized_pool_resource::upstream_resource() const
+    {
+        return &m_upstream;
+    }
+
+
+    PMR_DECL pool_options
+    unsynchronized_pool_resource::options() const
+    {
+        return m_opts;
+    }
+
+
+    PMR_DECL pool_resource_statistics
+    unsynchronized_pool_resource::stats() const
+    {
+        pool_resource_statistics result;
+        result.pools.reserve(m_pools.size());
+        for(const detail::pool& p : m_pools)
+        {
+            result.pools.push_back(p.stats());
+        }
+        result.oversized_blocks = m_oversized.top();
+        result.oversized_bytes = m_oversized.bytes();
+        return result;
+    }
+
+
+    PMR_DECL void*
+    unsynchronized_pool_resource::do_allocate(
+            std::size_t bytes, std::size_t align)
+    {
+        if(detail::pool* p = which_pool(bytes, align))
+        {
+            return p->allocate(m_upstream);
+        }
+        return m_oversized.extend(bytes, m_upstream, align);
+    }
+
+
+    PMR_DECL allocation_result<void*>
+    unsynchronized_pool_resource::do_allocate_at_least(
+            std::size_t bytes, std::size_t align)
+    {
+        if(detail::pool* p = which_pool(bytes, align))
+        {
+            return {p->allocate(m_upstream), p->block_size()};
+        }
+        return {m_oversized.extend(bytes, m_upstream, align), bytes};
+    }
+
+
+    PMR_DECL void
+    unsynchronized_pool_resource::do_deallocate(
+            void* ptr, std::size_t bytes, std::size_t align)
+    {
+        if(detail::pool* p = which_pool(bytes, align))
+        {
+            return p->deallocate(ptr);
+        }
+        m_oversized.deallocate(ptr, bytes, m_upstream);
+    }
+
+
+    PMR_DECL void
+    unsynchronized_pool_resource::do_allocate_bulk(void** out, std::size_t n,
+            std::size_t bytes, std::size_t align)
+    {
+        if(detail::pool* p = which_pool(bytes, align))
+        {
+            return p->allocate(out, n, m_upstream);
+        }
+        memory_resource::do_allocate_bulk(out, n, bytes, align);
+    }
+
+
+    PMR_DECL void
+    unsynchronized_pool_resource::do_deallocate_bulk(void* const* ptrs,
+            std::size_t n, std::size_t bytes, std::size_t align)
+    {
+        if(detail::pool* p = which_pool(bytes, align))
+        {
+            return p->deallocate(ptrs, n);
+        }
+        memory_resource::do_deallocate_bulk(ptrs, n, bytes, align);
+    }
+
+
+    PMR_DECL bool
+    unsynchronized_pool_resource::do_is_equal(
+            const memory_resource& other) const
+    {
+        return this == &other;
+    }
+
+
+    PMR_DECL void
+    unsynchronized_pool_resource::init_pools()
+    {
+        std::size_t count = detail::pool_count(m_opts);
+        m_pools.reserve(count);
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            m_pools.emplace_back(detail::min_pool_block_size << i,
+                    m_opts.max_blocks_per_chunk);
+        }
+    }
+
+
+    PMR_DECL void
+    unsynchronized_pool_resource::adjust_pool_options()
+    {
+        m_opts = detail::normalize(m_opts);
+    }
+
+
+    PMR_DECL detail::pool*
+    unsynchronized_pool_resource::which_pool(
+            std::size_t bytes, std::size_t align)
+    {
+        std::size_t size = std::max(bytes, align);
+        if(size > m_opts.largest_required_pool_block ||
+                align > detail::max_pool_block_align)
+        {
+            return nullptr;
+        }
+        return &m_pools[detail::pool_index(size)];
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "pmr/monotonic_buffer_resource.h"
+#include <cstddef>
+
+namespace pmr
+{
+    //! A monotonic_buffer_resource whose initial buffer of N bytes is part
+    //! of the object itself. Small arenas can be declared on the stack or in
+    //! a coroutine frame and only touch upstream once N bytes are exhausted.
+    //!
+    //! release() and reset() rewind to the embedded buffer, so an instance
+    //! can be reused without ever going upstream when its peak usage stays
+    //! below N.
+    template<std::size_t N>
+    class inline_monotonic_resource : public monotonic_buffer_resource
+    {
+        static_assert(N > 0, "inline capacity must be non-zero");
+
+      public:
+        //! Create an inline_monotonic_resource that will use the result of
+        //! pmr::get_default_resource() as its upstream memory_resource
+        inline_monotonic_resource() noexcept
+            : monotonic_buffer_resource{m_buffer, N}
+        {
+        }
+
+        //! Create an inline_monotonic_resource that allocates from the
+        //! supplied upstream memory_resource once the inline buffer is
+        //! exhausted
+        explicit inline_monotonic_resource(memory_resource* upstream) noexcept
+            : monotonic_buffer_resource{m_buffer, N, upstream}
+        {
+        }
+
+        //! The size of the embedded buffer
+        static constexpr std::size_t inline_capacity() noexcept
+        {
+            return N;
+        }
+
+      private:
+        // only its address is used before the base is constructed
+        alignas(std::max_align_t) unsigned char m_buffer[N];
+    };
+}
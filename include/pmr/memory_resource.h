@@ -1,10 +1,30 @@
 #pragma once
 
+#include <cassert>
 #include <cstdint>
 #include <cstddef>
 
 namespace pmr
 {
+    namespace detail
+    {
+        struct resource_access;
+    }
+
+
+    //! The result of an allocate_at_least call: the allocated pointer and
+    //! how much of the block is actually usable. count is in bytes when
+    //! returned from memory_resource and in objects when returned from
+    //! polymorphic_allocator. The block may be deallocated using any size
+    //! between the requested size and count.
+    template <typename Pointer>
+    struct allocation_result
+    {
+        Pointer ptr;
+        std::size_t count;
+    };
+
+
     //! Virtual base class for any type needing to encapsulate access
     //! to memory.
     class memory_resource
@@ -13,13 +33,14 @@ namespace pmr
         virtual ~memory_resource();
 
         //! Allocates uninitialized memory from this memory_resource
-        //! Behavior is undefined if the specified alignment is larger than
-        //! alignof(std::max_align_t). General behavior is implementation
-        //! defined by overriding do_allocate(std::size_t, std::size_t)
+        //! Behavior is undefined if the specified alignment is not a power
+        //! of two. General behavior is implementation defined by overriding
+        //! do_allocate(std::size_t, std::size_t)
         //!
         //! \param bytes The number of bytes to allocate
         //! \param align The alignment of the returned pointer; default
-        //!              is alignof(std::max_align_t)
+        //!              is alignof(std::max_align_t). May be larger than
+        //!              alignof(std::max_align_t)
         //! \return an untyped pointer to a contiguous block of memory of
         //!         at least bytes in size and with alignment as specified.
         //!         The return value is nullptr if bytes is zero
@@ -27,6 +48,19 @@ namespace pmr
         void* allocate(std::size_t bytes,
                 std::size_t align = alignof(std::max_align_t));
 
+        //! Allocates at least bytes of uninitialized memory and reports how
+        //! many bytes the caller may actually use. Delegates to
+        //! do_allocate_at_least(std::size_t, std::size_t)
+        //!
+        //! \param bytes The minimum number of bytes to allocate
+        //! \param align The alignment of the returned pointer
+        //! \return The allocated block and its usable size in bytes, which
+        //!         is at least bytes. The block is {nullptr, 0} if bytes is
+        //!         zero
+        //! \throws std::bad_alloc if unable to allocate the requested bytes
+        allocation_result<void*> allocate_at_least(std::size_t bytes,
+                std::size_t align = alignof(std::max_align_t));
+
         //! Delegates to do_deallocate(void*, std::size_t, std::size_t) to
         //! deallocate a chunk of memory allocated by this memory_resource
         //! implementation
@@ -38,6 +72,31 @@ namespace pmr
         void deallocate(void* ptr, std::size_t bytes,
                 std::size_t align = alignof(std::max_align_t));
 
+        //! Allocates n blocks of the same size and alignment in one call.
+        //! Delegates to do_allocate_bulk(void**, std::size_t, std::size_t,
+        //! std::size_t). If an exception is thrown no blocks are allocated.
+        //!
+        //! \param out Receives n pointers, each as if returned by
+        //!            allocate(bytes, align)
+        //! \param n The number of blocks to allocate
+        //! \param bytes The size of each block
+        //! \param align The alignment of each block
+        //! \throws std::bad_alloc if unable to allocate all n blocks
+        void allocate_bulk(void** out, std::size_t n, std::size_t bytes,
+                std::size_t align = alignof(std::max_align_t));
+
+        //! Deallocates n blocks of the same size and alignment in one call.
+        //! Delegates to do_deallocate_bulk(void* const*, std::size_t,
+        //! std::size_t, std::size_t)
+        //!
+        //! \param ptrs The n blocks to deallocate
+        //! \param n The number of blocks
+        //! \param bytes The size of each block
+        //! \param align The alignment of each block
+        void deallocate_bulk(void* const* ptrs, std::size_t n,
+                std::size_t bytes,
+                std::size_t align = alignof(std::max_align_t));
+
         //! Delegates to do_is_equal(const memory_resource*) const to
         //! determine implementation-defined equality of this memory_resource
         //!
@@ -69,6 +128,42 @@ namespace pmr
         virtual void do_deallocate(
                 void * ptr, std::size_t bytes, std::size_t align) = 0;
 
+        //! Allocates at least bytes and reports the usable size. The default
+        //! implementation calls do_allocate(std::size_t, std::size_t) and
+        //! reports exactly bytes; overrides that round requests up should
+        //! report the rounded size. Called with bytes > 0.
+        //!
+        //! \param bytes The minimum number of bytes to allocate
+        //! \param align The alignment of the returned pointer
+        //! \return The allocated block and its usable size in bytes
+        //! \throws std::bad_alloc if unable to allocate the requested bytes
+        virtual allocation_result<void*> do_allocate_at_least(
+                std::size_t bytes, std::size_t align);
+
+        //! Allocates n blocks of bytes each. The default implementation
+        //! calls do_allocate(std::size_t, std::size_t) n times; overrides
+        //! should satisfy the whole batch at once where they can. Called
+        //! with n > 0 and bytes > 0.
+        //!
+        //! \param out Receives the n allocated blocks
+        //! \param n The number of blocks to allocate
+        //! \param bytes The size of each block
+        //! \param align The alignment of each block
+        //! \throws std::bad_alloc if unable to allocate all n blocks, in
+        //!         which case none remain allocated
+        virtual void do_allocate_bulk(void** out, std::size_t n,
+                std::size_t bytes, std::size_t align);
+
+        //! Deallocates n blocks of bytes each. The default implementation
+        //! calls do_deallocate(void*, std::size_t, std::size_t) n times.
+        //!
+        //! \param ptrs The blocks to deallocate
+        //! \param n The number of blocks
+        //! \param bytes The size of each block
+        //! \param align The alignment of each block
+        virtual void do_deallocate_bulk(void* const* ptrs, std::size_t n,
+                std::size_t bytes, std::size_t align);
+
         //! Indicates implementation-defined equality of this memory_resource
         //!
         //! \param other Another memory_resource instance
@@ -77,6 +172,23 @@ namespace pmr
 
     };
 
+
+    inline void*
+    memory_resource::allocate(std::size_t bytes, std::size_t align)
+    {
+        assert(align > 0);
+        assert(!(align & (align - 1)));
+
+        return 0 == bytes ? nullptr : do_allocate(bytes, align);
+    }
+
+
+    inline void
+    memory_resource::deallocate(void* ptr, std::size_t bytes, std::size_t align)
+    {
+        return do_deallocate(ptr, bytes, align);
+    }
+
     //! Tests memory_resource instances for equality
     //!
     //! \return true iff the address of lhs is the same as the address of rhs
@@ -107,7 +219,9 @@ namespace pmr
     //! \relates memory_resource
     memory_resource* null_memory_resource() noexcept;
 
-    //! Access a global default memory_resource. The default if there has not
+    //! Access the default memory_resource of the calling thread: the one
+    //! installed by set_thread_default_resource(memory_resource*) if any,
+    //! otherwise the global default. The global default if there has not
     //! been a call to set_default_resource(memory_resource*) is to return
     //! the value from new_delete_resource().
     //!
@@ -127,4 +241,49 @@ namespace pmr
     //! \return the previously installed default memory_resource
     //! \relates memory_resource
     memory_resource* set_default_resource(memory_resource* mr) noexcept;
+
+    //! Sets a default memory_resource for the calling thread only, which
+    //! get_default_resource() returns in place of the global default.
+    //! Reading it touches no memory shared with other threads, so workers
+    //! can each route default-constructed allocators into a resource of
+    //! their own. The caller must keep mr alive while it is installed.
+    //!
+    //! \param mr The memory_resource to install for this thread. A nullptr
+    //!           removes the thread's default so that the global default
+    //!           applies again
+    //! \return the previously installed thread default, or nullptr if
+    //!         there was none
+    //! \relates memory_resource
+    memory_resource* set_thread_default_resource(memory_resource* mr) noexcept;
+
+    //! Installs a thread default memory_resource for its lifetime and then
+    //! restores the previous one. Scopes nest.
+    //!
+    //! \sa set_thread_default_resource(memory_resource*)
+    class scoped_default_resource
+    {
+      public:
+        explicit scoped_default_resource(memory_resource* mr) noexcept
+            : m_previous{set_thread_default_resource(mr)}
+        {
+        }
+
+        scoped_default_resource(const scoped_default_resource&) = delete;
+        scoped_default_resource& operator=(
+                const scoped_default_resource&) = delete;
+
+        ~scoped_default_resource()
+        {
+            set_thread_default_resource(m_previous);
+        }
+
+      private:
+        memory_resource* m_previous;
+    };
 }
+
+#ifdef PMR_HEADER_ONLY
+    // new_delete_resource() needs resource_adapter, so that header includes
+    // the implementation once both are complete
+#   include "pmr/resource_adapter.h"
+#endif
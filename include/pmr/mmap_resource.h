@@ -0,0 +1,88 @@
+#pragma once
+
+#include "pmr/memory_resource.h"
+#include "pmr/detail/config.h"
+#include <cstdint>
+
+#ifdef PMR_HAS_MMAP
+namespace pmr
+{
+    //! A memory_resource that maps memory directly from the operating system
+    //! with mmap and returns it with munmap. Every request is rounded up to
+    //! whole pages so this class is best used as the upstream of a
+    //! monotonic_buffer_resource or one of the pool resources, which request
+    //! large blocks. Instances are stateless and threadsafe. Only available
+    //! where PMR_HAS_MMAP is defined.
+    class mmap_resource : public memory_resource
+    {
+      public:
+        //! How pages backing allocations are sized
+        enum class page_mode
+        {
+            //! Ordinary pages of sysconf(_SC_PAGESIZE) bytes
+            normal,
+
+            //! Ordinary mappings aligned to huge page boundaries and marked
+            //! with madvise(MADV_HUGEPAGE) so that the kernel backs them with
+            //! transparent huge pages when it can
+            transparent_huge,
+
+            //! Mappings made with MAP_HUGETLB from the reserved huge page
+            //! pool. Falls back to transparent_huge when no huge pages are
+            //! available.
+            huge
+        };
+
+        //! Instantiate using page_mode::normal
+        mmap_resource() noexcept;
+
+        //! Instantiate using the given page_mode. The huge page modes use
+        //! the system's default huge page size, read from /proc/meminfo
+        //! where available and 2MiB otherwise.
+        //!
+        //! \param mode How the pages backing allocations are sized
+        explicit mmap_resource(page_mode mode) noexcept;
+
+        //! Instantiate using the given page_mode and huge page size
+        //!
+        //! \param mode How the pages backing allocations are sized
+        //! \param huge_page_size The size of the huge pages used by the huge
+        //!        page modes, a power of two. Ignored by page_mode::normal.
+        mmap_resource(page_mode mode, std::size_t huge_page_size) noexcept;
+
+        //! \returns The page_mode used by this instance
+        page_mode mode() const noexcept;
+
+        //! \returns The granularity to which allocation sizes are rounded
+        std::size_t page_size() const noexcept;
+
+      protected:
+        friend struct detail::resource_access;
+
+        //! Maps at least bytes of memory aligned to at least align
+        void* do_allocate(std::size_t bytes, std::size_t align) override;
+
+        //! Maps memory and reports the size rounded up to whole pages
+        allocation_result<void*> do_allocate_at_least(
+                std::size_t bytes, std::size_t align) override;
+
+        //! Unmaps memory previously mapped by an mmap_resource
+        void do_deallocate(
+                void* ptr, std::size_t bytes, std::size_t align) override;
+
+        //! \returns true iff other is an mmap_resource with the same
+        //!          page_mode and page size
+        bool do_is_equal(const memory_resource& other) const override;
+
+      private:
+        std::size_t mapping_size(std::size_t bytes) const;
+
+        page_mode m_mode;
+        std::size_t m_page_size;
+    };
+}
+#endif
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/mmap_resource.ipp"
+#endif
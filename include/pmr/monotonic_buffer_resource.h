@@ -1,7 +1,9 @@
 #pragma once
 
 #include "pmr/memory_resource.h"
+#include "pmr/detail/config.h"
 #include "pmr/detail/memblocks.h"
+#include <memory>
 
 namespace pmr
 {
@@ -67,22 +69,163 @@ namespace pmr
         monotonic_buffer_resource& operator=(
                 const monotonic_buffer_resource&) = delete;
 
-        //! Deallocate all blocks of memory allocated from upstream
+        //! Deallocate all blocks of memory allocated from upstream and
+        //! resume allocating from the initial buffer, if one was supplied
         void release();
 
+        //! Invalidate all memory allocated from this resource and resume
+        //! allocating from the initial buffer, keeping the blocks already
+        //! obtained from upstream for reuse. A resource that is reset
+        //! between batches of similar allocations stops calling upstream
+        //! once it has grown to the peak demand.
+        void reset() noexcept;
+
+        //! A position in a monotonic_buffer_resource that it can later be
+        //! rolled back to. Only valid until the resource is released, reset
+        //! or rolled back to an earlier checkpoint.
+        struct checkpoint
+        {
+            void* buf;
+            std::size_t size;
+            std::size_t blocks;
+            std::size_t next;
+            std::size_t allocated;
+            std::size_t padding;
+        };
+
+        //! Capture the current allocation position
+        checkpoint mark() const noexcept;
+
+        //! Invalidate all memory allocated since the checkpoint was taken.
+        //! Blocks obtained from upstream since then are kept for reuse as
+        //! they are by reset().
+        void rollback(const checkpoint& cp) noexcept;
+
+        //! Invalidate all memory allocated since the checkpoint was taken
+        //! and return the blocks obtained from upstream since then, so that
+        //! a burst of allocations does not keep its memory. Blocks held at
+        //! the checkpoint are kept, and the sizes of later requests to
+        //! upstream grow again from where they were.
+        void rollback_and_trim(const checkpoint& cp);
+
+        //! Rolls a monotonic_buffer_resource back to where it was when the
+        //! savepoint was constructed, unless commit() is called first
+        class savepoint
+        {
+          public:
+            explicit savepoint(monotonic_buffer_resource& mbr) noexcept
+                : m_mbr{&mbr}, m_checkpoint{mbr.mark()}
+            {
+            }
+
+            savepoint(const savepoint&) = delete;
+            savepoint& operator=(const savepoint&) = delete;
+
+            ~savepoint()
+            {
+                rollback();
+            }
+
+            //! Roll back now instead of at destruction
+            void rollback() noexcept
+            {
+                if(m_mbr)
+                {
+                    m_mbr->rollback(m_checkpoint);
+                    m_mbr = nullptr;
+                }
+            }
+
+            //! Keep everything allocated since construction
+            void commit() noexcept
+            {
+                m_mbr = nullptr;
+            }
+
+          private:
+            monotonic_buffer_resource* m_mbr;
+            checkpoint m_checkpoint;
+        };
+
         //! Get this instance's upstream memory_resource
         memory_resource* upstream_resource() const;
 
+        //! How the memory held by a monotonic_buffer_resource is used
+        struct statistics
+        {
+            //! Bytes handed out since construction or the last release(),
+            //! reset() or rollback(), including the tails handed over by
+            //! allocate_at_least()
+            std::size_t bytes_allocated;
+
+            //! Bytes skipped over to align those allocations
+            std::size_t bytes_padding;
+
+            //! Bytes held from upstream, including blocks kept for reuse
+            //! by reset() and rollback()
+            std::size_t bytes_reserved;
+
+            //! The number of blocks those bytes came in
+            std::size_t upstream_blocks;
+        };
+
+        //! Report how much memory is held and used. Comparing the bytes
+        //! allocated at peak with initial_size and the bytes reserved
+        //! shows how an instance should be sized.
+        statistics stats() const noexcept;
+
       private:
+        friend struct detail::resource_access;
+
+        // the bump is inline so statically typed callers such as
+        // resource_allocator reduce to it; refilling is out of line
         void* do_allocate(std::size_t bytes, std::size_t align) override;
+        allocation_result<void*> do_allocate_at_least(
+                std::size_t bytes, std::size_t align) override;
         void do_deallocate(void*, std::size_t, std::size_t) override;
+        void do_allocate_bulk(void** out, std::size_t n, std::size_t bytes,
+                std::size_t align) override;
         bool do_is_equal(const memory_resource& other) const override;
+        PMR_COLD void* allocate_from_next_buffer(
+                std::size_t bytes, std::size_t align);
         void recalculate_next_buffer_size();
 
         memory_resource& m_upstream;
+        void* m_initialbuf;
+        std::size_t m_initialbuf_size;
         void* m_currentbuf;
         std::size_t m_currentbuf_size;
         std::size_t m_nextbuf_size;
+        std::size_t m_initial_nextbuf_size; // restored by release()
+        std::size_t m_allocated_bytes;
+        std::size_t m_padding_bytes;
         detail::memblocks m_blocks;
     };
+
+
+    inline void*
+    monotonic_buffer_resource::do_allocate(std::size_t bytes, std::size_t align)
+    {
+        std::size_t space = m_currentbuf_size;
+        void* allocated = std::align(align, bytes, m_currentbuf, m_currentbuf_size);
+        if(!allocated)
+        {
+            return allocate_from_next_buffer(bytes, align);
+        }
+        m_padding_bytes += space - m_currentbuf_size;
+        m_allocated_bytes += bytes;
+        m_currentbuf = static_cast<char*>(m_currentbuf) + bytes;
+        m_currentbuf_size -= bytes;
+        return allocated;
+    }
+
+
+    inline void
+    monotonic_buffer_resource::do_deallocate(void*, std::size_t, std::size_t)
+    {
+    }
 }
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/monotonic_buffer_resource.ipp"
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "pmr/mmap_resource.h"
+#include <cstdint>
+
+#ifdef PMR_HAS_MMAP
+namespace pmr
+{
+    //! An mmap_resource that asks the kernel to place the pages it maps on
+    //! a particular NUMA node. The node is either fixed at construction or,
+    //! for instances constructed with numa_resource::local_node, the node of
+    //! the CPU the allocating thread is running on.
+    //!
+    //! Placement uses the preferred policy so that an exhausted node spills
+    //! over to others rather than failing. On systems with a single node, or
+    //! where the kernel refuses the request, memory is mapped without a
+    //! policy. Instances are stateless and threadsafe. Only available where
+    //! PMR_HAS_MMAP is defined.
+    class numa_resource : public mmap_resource
+    {
+      public:
+        //! Selects the node of the calling thread at each allocation. An
+        //! enumerator so that it needs no definition in header-only builds.
+        enum : int { local_node = -1 };
+
+        //! Instantiate placing memory on the calling thread's current node
+        numa_resource() noexcept;
+
+        //! Instantiate placing memory on the given node
+        //!
+        //! \param node A node number in [0, node_count()) or local_node
+        //! \param mode How the pages backing allocations are sized
+        explicit numa_resource(int node,
+                page_mode mode = page_mode::normal) noexcept;
+
+        //! \returns The node this instance places memory on, or local_node
+        int node() const noexcept;
+
+        //! \returns The number of NUMA nodes on this system; at least 1
+        static std::size_t node_count() noexcept;
+
+        //! \returns The node of the CPU the calling thread is running on
+        static int current_node() noexcept;
+
+      protected:
+        friend struct detail::resource_access;
+
+        //! Maps at least bytes aligned to at least align on this instance's
+        //! node
+        void* do_allocate(std::size_t bytes, std::size_t align) override;
+
+        //! Maps memory on this instance's node and reports the size rounded
+        //! up to whole pages
+        allocation_result<void*> do_allocate_at_least(
+                std::size_t bytes, std::size_t align) override;
+
+      private:
+        int m_node;
+    };
+}
+#endif
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/numa_resource.ipp"
+#endif
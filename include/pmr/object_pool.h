@@ -0,0 +1,282 @@
+#pragma once
+
+#include "pmr/memory_resource.h"
+#include "pmr/pool_statistics.h"
+#include "pmr/detail/config.h"
+#include "pmr/detail/memblocks.h"
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <functional>
+#include <utility>
+
+namespace pmr
+{
+    //! Creates and destroys objects of a single type in slots carved from
+    //! chunks of memory requested from an upstream memory_resource. Slots
+    //! are exactly as large as T allows, rather than rounded up to a size
+    //! class, and create() and destroy() are a freelist pop and push.
+    //!
+    //! clear() destroys every live object at once and keeps the chunks for
+    //! reuse; for trivially destructible T it does not visit the objects
+    //! at all. Chunks start small and grow geometrically up to
+    //! max_objects_per_chunk slots. This class is not threadsafe.
+    template <typename T>
+    class object_pool
+    {
+      public:
+        //! Enumerators so that they need no definition
+        enum : std::size_t
+        {
+            //! The alignment of every slot
+            slot_align = alignof(T) > alignof(void*)
+                ? alignof(T) : alignof(void*),
+
+            //! The distance between neighbouring slots; a free slot holds
+            //! a pointer to the next
+            slot_size = ((sizeof(T) > sizeof(void*)
+                    ? sizeof(T) : sizeof(void*)) + slot_align - 1)
+                / slot_align * slot_align,
+
+            //! Used when no max_objects_per_chunk is given
+            default_max_objects_per_chunk = 1024
+        };
+
+        //! Instantiate using the result of pmr::get_default_resource() as
+        //! the upstream memory_resource
+        object_pool() noexcept
+            : object_pool(0, nullptr)
+        {
+        }
+
+        //! \param upstream The memory_resource to use as an upstream memory
+        //!                 provider
+        explicit object_pool(memory_resource* upstream) noexcept
+            : object_pool(0, upstream)
+        {
+        }
+
+        //! \param max_objects_per_chunk The most slots requested from
+        //!                              upstream at once; zero selects
+        //!                              default_max_objects_per_chunk
+        //! \param upstream The memory_resource to use as an upstream memory
+        //!                 provider
+        object_pool(std::size_t max_objects_per_chunk,
+                memory_resource* upstream) noexcept
+            : m_upstream{upstream ? *upstream : *get_default_resource()}
+            , m_max_objects_per_chunk{max_objects_per_chunk
+                ? max_objects_per_chunk
+                : std::size_t(default_max_objects_per_chunk)}
+            , m_next_objects_per_chunk{initial_objects_per_chunk()}
+        {
+        }
+
+        object_pool(const object_pool&) = delete;
+
+        //! \sa release()
+        ~object_pool()
+        {
+            release();
+        }
+
+        object_pool& operator=(const object_pool&) = delete;
+
+        //! Construct a T from args in a free slot
+        //!
+        //! \throws std::bad_alloc if no slot could be obtained, or whatever
+        //!         the constructor of T throws
+        template <typename... Args>
+        T* create(Args&&... args)
+        {
+            void* slot = allocate();
+            try
+            {
+                return ::new (slot) T(std::forward<Args>(args)...);
+            }
+            catch(...)
+            {
+                deallocate(slot);
+                throw;
+            }
+        }
+
+        //! Destroy an object made by create() and free its slot
+        void destroy(T* obj) noexcept
+        {
+            obj->~T();
+            deallocate(obj);
+        }
+
+        //! Destroy every live object and free all slots, keeping the
+        //! chunks they are in
+        void clear() noexcept
+        {
+            destroy_live(std::is_trivially_destructible<T>{});
+            m_chunks.recycle();
+            m_free = nullptr;
+            m_next = nullptr;
+            m_end = nullptr;
+            m_live = 0;
+        }
+
+        //! Destroy every live object and return all chunks to upstream
+        void release() noexcept
+        {
+            clear();
+            m_chunks.release(m_upstream);
+            m_next_objects_per_chunk = initial_objects_per_chunk();
+        }
+
+        //! \returns The number of live objects
+        std::size_t size() const noexcept
+        {
+            return m_live;
+        }
+
+        //! Describe the slots held by this instance
+        pool_statistics stats() const noexcept
+        {
+            std::size_t slots = m_chunks.bytes() / slot_size;
+            return {slot_size, m_chunks.count(), slots, m_live,
+                slots - m_live};
+        }
+
+        //! Access the upstream memory resource used by this instance
+        memory_resource* upstream_resource() const
+        {
+            return &m_upstream;
+        }
+
+      private:
+        struct free_slot
+        {
+            free_slot* next;
+        };
+
+        void* allocate()
+        {
+            void* slot;
+            if(m_free)
+            {
+                slot = m_free;
+                m_free = m_free->next;
+            }
+            else
+            {
+                if(m_next == m_end)
+                {
+                    extend();
+                }
+                slot = m_next;
+                m_next += slot_size;
+            }
+            ++m_live;
+            return slot;
+        }
+
+        void deallocate(void* slot) noexcept
+        {
+            m_free = ::new (slot) free_slot{m_free};
+            --m_live;
+        }
+
+        std::size_t initial_objects_per_chunk() const noexcept
+        {
+            return std::max<std::size_t>(1, std::min<std::size_t>(
+                        4096 / slot_size, m_max_objects_per_chunk));
+        }
+
+        PMR_COLD void extend()
+        {
+            // chunks kept by clear() come first
+            std::size_t bytes = 0;
+            void* chunk = m_chunks.reuse(slot_size, slot_align, bytes);
+            if(!chunk)
+            {
+                bytes = m_next_objects_per_chunk * slot_size;
+                chunk = m_chunks.extend(bytes, m_upstream, slot_align);
+                m_next_objects_per_chunk = std::min(
+                        m_next_objects_per_chunk * 2, m_max_objects_per_chunk);
+            }
+            m_next = static_cast<char*>(chunk);
+            m_end = m_next + bytes / slot_size * slot_size;
+        }
+
+        void destroy_live(std::true_type) noexcept
+        {
+        }
+
+        PMR_COLD void destroy_live(std::false_type) noexcept
+        {
+            if(0 == m_live)
+            {
+                return;
+            }
+
+            // every carved slot not on the freelist holds an object; with
+            // both the chunks and the freelist in address order, one pass
+            // over each tells them apart without allocating
+            const void* newest = m_chunks.in_use()[m_chunks.top() - 1].ptr;
+            m_chunks.sort_in_use();
+            free_slot* f = sort_by_address(m_free);
+            const detail::block* chunks = m_chunks.in_use();
+            for(std::size_t i = 0; i < m_chunks.top(); ++i)
+            {
+                char* slot = static_cast<char*>(chunks[i].ptr);
+                char* end = chunks[i].ptr == newest ? m_next
+                    : slot + chunks[i].size / slot_size * slot_size;
+                for(; slot != end; slot += slot_size)
+                {
+                    if(reinterpret_cast<char*>(f) == slot)
+                    {
+                        f = f->next;
+                    }
+                    else
+                    {
+                        reinterpret_cast<T*>(slot)->~T();
+                    }
+                }
+            }
+        }
+
+        // a merge sort, recursing to a depth logarithmic in the length
+        static free_slot* sort_by_address(free_slot* list) noexcept
+        {
+            if(!list || !list->next)
+            {
+                return list;
+            }
+            free_slot* middle = list;
+            for(free_slot* end = list->next; end && end->next;
+                    end = end->next->next)
+            {
+                middle = middle->next;
+            }
+            free_slot* a = sort_by_address(middle->next);
+            middle->next = nullptr;
+            free_slot* b = sort_by_address(list);
+
+            free_slot* head = nullptr;
+            free_slot** tail = &head;
+            while(a && b)
+            {
+                free_slot*& first = std::less<free_slot*>()(a, b) ? a : b;
+                *tail = first;
+                tail = &first->next;
+                first = first->next;
+            }
+            *tail = a ? a : b;
+            return head;
+        }
+
+        memory_resource& m_upstream;
+        std::size_t m_max_objects_per_chunk;
+        std::size_t m_next_objects_per_chunk;
+        free_slot* m_free = nullptr;
+        char* m_next = nullptr; // uncarved remainder of the newest chunk
+        char* m_end = nullptr;
+        std::size_t m_live = 0;
+        detail::memblocks m_chunks;
+    };
+}
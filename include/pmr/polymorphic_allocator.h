@@ -64,6 +64,15 @@ namespace pmr
         //! \return a pointer to the beginning of the allocated block
         pointer allocate(std::size_t n);
 
+        //! Allocates _uninitialized_ memory for at least n copies of T with
+        //! alignof(T), reporting how many actually fit so that containers
+        //! can make use of any slack left by the memory_resource
+        //!
+        //! \param n The minimum number of T instances to allocate space for
+        //! \return a pointer to the beginning of the allocated block and the
+        //!         number of T instances it can hold
+        allocation_result<pointer> allocate_at_least(std::size_t n);
+
         //! Deallocate memory block pointed at by pointer of size n * sizeof(T)
         //!
         //! \param ptr A pointer to the block to deallocate
@@ -232,6 +241,16 @@ namespace pmr
     }
 
 
+    template <typename T>
+    allocation_result<T*>
+    polymorphic_allocator<T>::allocate_at_least(std::size_t n)
+    {
+        allocation_result<void*> result =
+            m_memory->allocate_at_least(n * sizeof(T), alignof(T));
+        return {static_cast<T*>(result.ptr), result.count / sizeof(T)};
+    }
+
+
     template <typename T>
     void
     polymorphic_allocator<T>::deallocate(T* ptr, std::size_t n)
@@ -11,7 +11,13 @@ namespace pmr
     //! \sa pmr::unsynchronized_pool_resource
     struct pool_options
     {
+        //! The most blocks a pool will request from upstream at once. Pools
+        //! start with small chunks and grow geometrically up to this limit.
+        //! Zero selects an implementation default.
         std::size_t max_blocks_per_chunk = 0;
+
+        //! Requests larger than this go directly to the upstream resource.
+        //! Zero selects an implementation default.
         std::size_t largest_required_pool_block = 0;
     };
 }
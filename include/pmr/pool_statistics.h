@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace pmr
+{
+    //! Describes one pool of a pool-based memory_resource
+    struct pool_statistics
+    {
+        //! The size of the blocks the pool serves
+        std::size_t block_size;
+
+        //! The chunks the pool obtained from upstream
+        std::size_t chunks;
+
+        //! The blocks in those chunks
+        std::size_t blocks;
+
+        //! Blocks handed out and not yet deallocated
+        std::size_t used_blocks;
+
+        //! Blocks ready to be handed out, blocks - used_blocks
+        std::size_t free_blocks;
+    };
+
+
+    //! Describes the memory held by a pool-based memory_resource. Comparing
+    //! used with free blocks shows whether pool_options::max_blocks_per_chunk
+    //! over-provisions and the oversized allocations whether
+    //! pool_options::largest_required_pool_block is too small.
+    //!
+    //! \sa pmr::synchronized_pool_resource
+    //! \sa pmr::unsynchronized_pool_resource
+    struct pool_resource_statistics
+    {
+        //! One entry per pool in order of increasing block size
+        std::vector<pool_statistics> pools;
+
+        //! Allocations too large for any pool, made directly upstream
+        std::size_t oversized_blocks;
+        std::size_t oversized_bytes;
+    };
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "pmr/memory_resource.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pmr
+{
+    //! One record of an allocation trace. Traces are a trace_header
+    //! followed by these records in the order the calls were made, written
+    //! in the byte order of the recording machine.
+    struct trace_event
+    {
+        enum kind : std::uint8_t { allocate = 0, deallocate = 1 };
+
+        //! Nanoseconds since recording started
+        std::uint64_t timestamp;
+
+        //! Numbers allocations from zero in the order they were made; a
+        //! deallocation carries the id of the allocation it returns, or
+        //! unknown_id if the pointer was not allocated through the recorder
+        std::uint64_t id;
+
+        std::uint64_t bytes;
+        std::uint32_t align;
+
+        //! Threads are numbered from zero in the order they first called
+        //! into the recorder
+        std::uint32_t thread;
+
+        std::uint8_t op;
+        std::uint8_t reserved[7];
+
+        enum : std::uint64_t { unknown_id = ~std::uint64_t(0) };
+    };
+
+    //! Starts every trace file
+    struct trace_header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t event_size;
+    };
+
+
+    //! A memory_resource that forwards to an upstream resource and records
+    //! every allocation and deallocation to a trace file, which
+    //! read_trace() loads for offline analysis and replay. Records are
+    //! buffered and written when the buffer fills, on flush() and on
+    //! destruction. Instances are threadsafe; calls are serialised so that
+    //! the trace holds them in a consistent order.
+    class recording_resource : public memory_resource
+    {
+      public:
+        //! Instantiate recording to the file at path, which is truncated
+        //!
+        //! \throws std::system_error if the file cannot be opened
+        explicit recording_resource(const char* path,
+                memory_resource* upstream = nullptr);
+
+        recording_resource(const recording_resource&) = delete;
+        recording_resource& operator=(const recording_resource&) = delete;
+
+        //! Writes any buffered records and closes the file
+        ~recording_resource();
+
+        //! Writes buffered records to the file
+        //!
+        //! \throws std::system_error if this or any earlier write failed
+        void flush();
+
+        //! \returns The number of records so far
+        std::uint64_t events() const;
+
+        memory_resource* upstream_resource() const;
+
+      protected:
+        friend struct detail::resource_access;
+
+        void* do_allocate(std::size_t bytes, std::size_t align) override;
+        void do_deallocate(void* ptr, std::size_t bytes,
+                std::size_t align) override;
+        bool do_is_equal(const memory_resource& other) const override;
+
+      private:
+        void record(trace_event::kind op, std::uint64_t id,
+                std::size_t bytes, std::size_t align);
+        void write_buffer();
+
+        memory_resource& m_upstream;
+        std::FILE* m_file;
+        std::chrono::steady_clock::time_point m_start;
+        mutable std::mutex m_lock;
+        std::vector<trace_event> m_buffer;
+        std::unordered_map<void*, std::uint64_t> m_ids;
+        std::unordered_map<std::thread::id, std::uint32_t> m_threads;
+        std::uint64_t m_next_id;
+        std::uint64_t m_events;
+        int m_write_error;
+    };
+
+
+    //! Loads a trace written by recording_resource
+    //!
+    //! \throws std::system_error if the file cannot be read and
+    //!         std::runtime_error if it is not a trace of this version
+    std::vector<trace_event> read_trace(const char* path);
+}
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/recording_resource.ipp"
+#endif
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "pmr/memory_resource.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <new>
 #include <utility>
 
 namespace pmr
@@ -55,6 +59,8 @@ namespace pmr
         allocator_type get_allocator() const;
 
       protected:
+        friend struct detail::resource_access;
+
         //! Allocates memory using this instances instance of allocator_type
         //!
         //! \param bytes The number of bytes to allocate
@@ -63,6 +69,17 @@ namespace pmr
         //!          at least bytes
         void* do_allocate(std::size_t bytes, std::size_t align);
 
+        //! Allocates memory using this instances instance of allocator_type
+        //! and reports the bytes gained by rounding up to whole multiples of
+        //! the alignment
+        //!
+        //! \param bytes The minimum number of bytes to allocate
+        //! \param align The required alignment of the returned pointer
+        //! \returns A pointer to a suitably aligned block of memory and its
+        //!          usable size
+        allocation_result<void*> do_allocate_at_least(
+                std::size_t bytes, std::size_t align);
+
         //! Deallocates memory previously allocated by this instance
         //!
         //! \param ptr A pointer to the memory to deallocate
@@ -87,6 +104,10 @@ namespace pmr
         template <std::size_t align>
         void do_deallocate(void* ptr, std::size_t bytes);
 
+        void* do_allocate_overaligned(std::size_t bytes, std::size_t align);
+        void do_deallocate_overaligned(
+                void* ptr, std::size_t bytes, std::size_t align);
+
         Alloc m_alloc;
     };
 
@@ -126,6 +147,10 @@ namespace pmr
     resource_adapter_impl<Alloc>::do_allocate(
             std::size_t bytes, std::size_t align)
     {
+        if(align > alignof(std::max_align_t))
+        {
+            return do_allocate_overaligned(bytes, align);
+        }
         switch(align)
         {
             case   1: return do_allocate<1>(bytes);
@@ -141,11 +166,29 @@ namespace pmr
     }
 
 
+    template <typename Alloc>
+    allocation_result<void*>
+    resource_adapter_impl<Alloc>::do_allocate_at_least(
+            std::size_t bytes, std::size_t align)
+    {
+        void* ptr = do_allocate(bytes, align);
+        if(align > alignof(std::max_align_t))
+        {
+            return {ptr, bytes};
+        }
+        return {ptr, (bytes / align + (0 != bytes % align)) * align};
+    }
+
+
     template <typename Alloc>
     void
     resource_adapter_impl<Alloc>::do_deallocate(
             void* ptr, std::size_t bytes, std::size_t align)
     {
+        if(align > alignof(std::max_align_t))
+        {
+            return do_deallocate_overaligned(ptr, bytes, align);
+        }
         switch(align)
         {
             case   1: return do_deallocate<1>(ptr, bytes);
@@ -184,7 +227,7 @@ namespace pmr
         using aligner_traits =
             typename traits::template rebind_traits<aligner>;
 
-        std::size_t n = (bytes + align - 1) / align;
+        std::size_t n = bytes / align + (0 != bytes % align);
         typename aligner_traits::allocator_type alloc(m_alloc);
         return aligner_traits::allocate(alloc, n);
     }
@@ -199,13 +242,46 @@ namespace pmr
         using aligner_traits =
             typename traits::template rebind_traits<aligner>;
 
-        std::size_t n = (bytes + align - 1) / align;
+        std::size_t n = bytes / align + (0 != bytes % align);
         typename aligner_traits::allocator_type alloc(m_alloc);
         return aligner_traits::deallocate(alloc,
                 reinterpret_cast<typename aligner_traits::pointer>(ptr), n);
     }
 
 
+    template <typename Alloc>
+    void*
+    resource_adapter_impl<Alloc>::do_allocate_overaligned(
+            std::size_t bytes, std::size_t align)
+    {
+        // Allocators can't be relied upon to honor extended alignment so
+        // over-allocate and stash the original pointer just before the
+        // aligned one. The base is aligned to max_align_t and align is
+        // larger, so there is always at least that much room.
+        constexpr std::size_t base_align = alignof(std::max_align_t);
+        if(std::numeric_limits<std::size_t>::max() - align < bytes)
+        {
+            throw std::bad_alloc();
+        }
+        char* base = static_cast<char*>(do_allocate<base_align>(bytes + align));
+        char* aligned =
+            base + (align - reinterpret_cast<std::uintptr_t>(base) % align);
+        reinterpret_cast<char**>(aligned)[-1] = base;
+        return aligned;
+    }
+
+
+    template <typename Alloc>
+    void
+    resource_adapter_impl<Alloc>::do_deallocate_overaligned(
+            void* ptr, std::size_t bytes, std::size_t align)
+    {
+        constexpr std::size_t base_align = alignof(std::max_align_t);
+        char* base = reinterpret_cast<char**>(ptr)[-1];
+        do_deallocate<base_align>(base, bytes + align);
+    }
+
+
     //! \class pmr::resource_adapter
     //! This alias template rebinds the Alloc to the char type such that
     //! specializations of the same allocator type always yield the same type
@@ -216,3 +292,7 @@ namespace pmr
     using resource_adapter = resource_adapter_impl<
         typename std::allocator_traits<Alloc>::template rebind_alloc<char>>;
 }
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/memory_resource.ipp"
+#endif
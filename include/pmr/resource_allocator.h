@@ -0,0 +1,205 @@
+#pragma once
+
+#include "memory_resource.h"
+#include "polymorphic_allocator.h"
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace pmr
+{
+    namespace detail
+    {
+        //! Calls a resource's own do_allocate/do_deallocate rather than
+        //! going through the virtual memory_resource interface. Resources
+        //! in this library befriend it; other resources, whose overrides
+        //! are not accessible here, fall back to the virtual call.
+        struct resource_access
+        {
+            template <typename Resource>
+            static void* allocate(Resource& r, std::size_t bytes,
+                    std::size_t align)
+            {
+                return allocate(r, bytes, align, 0);
+            }
+
+
+            template <typename Resource>
+            static void deallocate(Resource& r, void* ptr, std::size_t bytes,
+                    std::size_t align)
+            {
+                deallocate(r, ptr, bytes, align, 0);
+            }
+
+          private:
+            template <typename Resource>
+            static auto allocate(Resource& r, std::size_t bytes,
+                    std::size_t align, int) ->
+                decltype(r.Resource::do_allocate(bytes, align))
+            {
+                return 0 == bytes ? nullptr
+                    : r.Resource::do_allocate(bytes, align);
+            }
+
+
+            template <typename Resource>
+            static void* allocate(Resource& r, std::size_t bytes,
+                    std::size_t align, long)
+            {
+                return r.allocate(bytes, align);
+            }
+
+
+            template <typename Resource>
+            static auto deallocate(Resource& r, void* ptr, std::size_t bytes,
+                    std::size_t align, int) ->
+                decltype(r.Resource::do_deallocate(ptr, bytes, align))
+            {
+                r.Resource::do_deallocate(ptr, bytes, align);
+            }
+
+
+            template <typename Resource>
+            static void deallocate(Resource& r, void* ptr, std::size_t bytes,
+                    std::size_t align, long)
+            {
+                r.deallocate(ptr, bytes, align);
+            }
+        };
+    }
+
+
+    //! An allocator bound to a memory_resource of the known, concrete type
+    //! Resource. Calls into the resource are made non-virtually, so the
+    //! fast path of a resource whose allocation is defined in its header,
+    //! like monotonic_buffer_resource, inlines into the caller.
+    //!
+    //! Instances convert to polymorphic_allocator and compare equal to a
+    //! polymorphic_allocator using the same resource. Objects constructed
+    //! through it receive the resource by the same uses-allocator rules as
+    //! polymorphic_allocator, so nested pmr containers share the resource.
+    //!
+    //! Resource must not be a base class of the resource actually used;
+    //! the call would bypass the most derived override.
+    template <typename T, typename Resource>
+    class resource_allocator
+    {
+      public:
+        using value_type = T;
+        using resource_type = Resource;
+
+        template <typename U>
+        struct rebind { using other = resource_allocator<U, Resource>; };
+
+        //! Instantiate a resource_allocator that will use the supplied
+        //! resource. Intentionally not explicit, like polymorphic_allocator.
+        //!
+        //! \param r The wrapped resource
+        resource_allocator(Resource* r) noexcept
+            : m_resource{r}
+        {
+            assert(r);
+        }
+
+        //! Instantiate a resource_allocator that will use the same resource
+        //! as the supplied argument
+        template <typename U>
+        resource_allocator(const resource_allocator<U, Resource>& other) noexcept
+            : m_resource{other.resource()}
+        {
+        }
+
+        //! Allocates enough _uninitialized_ memory for n copies of T
+        //! with alignof(T)
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(detail::resource_access::allocate(
+                        *m_resource, n * sizeof(T), alignof(T)));
+        }
+
+        //! Deallocate memory block pointed at by ptr of size n * sizeof(T)
+        void deallocate(T* ptr, std::size_t n)
+        {
+            detail::resource_access::deallocate(
+                    *m_resource, ptr, n * sizeof(T), alignof(T));
+        }
+
+        //! Constructs an instance of U as polymorphic_allocator would
+        template <typename U, typename... Args>
+        void construct(U* ptr, Args&&... args)
+        {
+            polymorphic_allocator<T>{m_resource}.construct(
+                    ptr, std::forward<Args>(args)...);
+        }
+
+        template <typename U>
+        void destroy(U* ptr)
+        {
+            ptr->~U();
+        }
+
+        //! Access the underlying resource
+        Resource* resource() const noexcept
+        {
+            return m_resource;
+        }
+
+        //! A polymorphic_allocator using the same resource
+        template <typename U>
+        operator polymorphic_allocator<U>() const noexcept
+        {
+            return polymorphic_allocator<U>{m_resource};
+        }
+
+      private:
+        Resource* m_resource;
+    };
+
+
+    template <typename T, typename U, typename Resource>
+    bool operator==(const resource_allocator<T, Resource>& lhs,
+            const resource_allocator<U, Resource>& rhs) noexcept
+    {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+
+    template <typename T, typename U, typename Resource>
+    bool operator!=(const resource_allocator<T, Resource>& lhs,
+            const resource_allocator<U, Resource>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+
+    template <typename T, typename U, typename Resource>
+    bool operator==(const resource_allocator<T, Resource>& lhs,
+            const polymorphic_allocator<U>& rhs) noexcept
+    {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+
+    template <typename T, typename U, typename Resource>
+    bool operator==(const polymorphic_allocator<U>& lhs,
+            const resource_allocator<T, Resource>& rhs) noexcept
+    {
+        return rhs == lhs;
+    }
+
+
+    template <typename T, typename U, typename Resource>
+    bool operator!=(const resource_allocator<T, Resource>& lhs,
+            const polymorphic_allocator<U>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+
+    template <typename T, typename U, typename Resource>
+    bool operator!=(const polymorphic_allocator<U>& lhs,
+            const resource_allocator<T, Resource>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
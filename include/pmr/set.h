@@ -10,5 +10,5 @@ namespace pmr
 
 
     template <typename K, typename Comp = std::less<K>>
-    using multiset = std::set<K, Comp, polymorphic_allocator<K>>;
+    using multiset = std::multiset<K, Comp, polymorphic_allocator<K>>;
 }
@@ -0,0 +1,348 @@
+#pragma once
+
+#include "pmr/memory_resource.h"
+#include "pmr/detail/config.h"
+#include "pmr/detail/memblocks.h"
+#include "pmr/detail/pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace pmr
+{
+    namespace detail
+    {
+        template <std::size_t... I>
+        struct index_list
+        {
+        };
+
+
+        template <typename A, typename B>
+        struct concat_index_lists;
+
+        template <std::size_t... I, std::size_t... J>
+        struct concat_index_lists<index_list<I...>, index_list<J...>>
+        {
+            using type = index_list<I..., (sizeof...(I) + J)...>;
+        };
+
+
+        //! index_list<0, ..., N - 1>, built in logarithmic depth
+        template <std::size_t N>
+        struct make_index_list : concat_index_lists<
+                typename make_index_list<N / 2>::type,
+                typename make_index_list<N - N / 2>::type>
+        {
+        };
+
+        template <>
+        struct make_index_list<0>
+        {
+            using type = index_list<>;
+        };
+
+        template <>
+        struct make_index_list<1>
+        {
+            using type = index_list<0>;
+        };
+
+
+        //! Compile-time queries over a list of block sizes
+        template <std::size_t... Sizes>
+        struct size_class_list;
+
+        template <>
+        struct size_class_list<>
+        {
+            static constexpr std::size_t index(std::size_t) noexcept
+            {
+                return 0;
+            }
+
+            static constexpr bool ascending(std::size_t) noexcept
+            {
+                return true;
+            }
+
+            static constexpr bool multiples_of(std::size_t) noexcept
+            {
+                return true;
+            }
+
+            static constexpr std::size_t largest() noexcept
+            {
+                return 0;
+            }
+        };
+
+        template <std::size_t Head, std::size_t... Tail>
+        struct size_class_list<Head, Tail...>
+        {
+            //! The first class with blocks of at least bytes; the number of
+            //! classes if there is none
+            static constexpr std::size_t index(std::size_t bytes) noexcept
+            {
+                return bytes <= Head
+                    ? 0 : 1 + size_class_list<Tail...>::index(bytes);
+            }
+
+            static constexpr bool ascending(std::size_t previous) noexcept
+            {
+                return previous < Head
+                    && size_class_list<Tail...>::ascending(Head);
+            }
+
+            static constexpr bool multiples_of(std::size_t n) noexcept
+            {
+                return 0 == Head % n
+                    && size_class_list<Tail...>::multiples_of(n);
+            }
+
+            static constexpr std::size_t largest() noexcept
+            {
+                return Head < size_class_list<Tail...>::largest()
+                    ? size_class_list<Tail...>::largest() : Head;
+            }
+        };
+
+
+        //! Maps a request of up to the largest class, rounded up to a
+        //! multiple of granule, to its class
+        template <typename Classes, std::size_t Granule, typename Indices>
+        struct size_class_table;
+
+        template <typename Classes, std::size_t Granule, std::size_t... I>
+        struct size_class_table<Classes, Granule, index_list<I...>>
+        {
+            static constexpr std::uint8_t value[sizeof...(I)] = {
+                static_cast<std::uint8_t>(Classes::index(I * Granule))...
+            };
+        };
+
+        template <typename Classes, std::size_t Granule, std::size_t... I>
+        constexpr std::uint8_t
+        size_class_table<Classes, Granule, index_list<I...>>::value[
+            sizeof...(I)];
+    }
+
+
+    //! A memory_resource serving blocks of sizes fixed at compile time,
+    //! for when the sizes of the objects to pool are known. A request is
+    //! mapped to its size class by a single lookup in a table built by the
+    //! compiler, and the allocate and deallocate paths are inline, so
+    //! calls through a static_pool_resource of known type compile down to
+    //! a table load and a freelist push or pop.
+    //!
+    //! Sizes must ascend and be multiples of the pointer size. Each class
+    //! carves its blocks from upstream chunks of about chunk_size bytes.
+    //! Blocks are aligned to the largest power of two dividing their size,
+    //! up to detail::max_pool_block_align. A request aligned more strictly
+    //! than its class is served by the next class aligned strictly enough.
+    //! Larger requests and those no class is aligned for go directly
+    //! upstream.
+    //! This class is not threadsafe.
+    //!
+    //! \sa pmr::unsynchronized_pool_resource
+    template <std::size_t... SizeClasses>
+    class static_pool_resource : public memory_resource
+    {
+        using classes = detail::size_class_list<SizeClasses...>;
+
+      public:
+        //! Enumerators so that they need no definition
+        enum : std::size_t
+        {
+            //! The number of size classes
+            class_count = sizeof...(SizeClasses),
+
+            //! The largest block served from a pool
+            max_block_size = classes::largest(),
+
+            //! Requests are looked up in steps of this many bytes
+            granule = sizeof(void*),
+
+            //! The upstream request size a class's chunks aim for
+            chunk_size = 16 * 1024
+        };
+
+        static_assert(class_count > 0 && class_count < 255,
+                "between 1 and 254 size classes are supported");
+        static_assert(classes::ascending(0),
+                "size classes must be given in ascending order");
+        static_assert(classes::multiples_of(granule),
+                "size classes must be multiples of the pointer size");
+
+        //! Instantiate using the result of pmr::get_default_resource() as
+        //! the upstream memory_resource
+        static_pool_resource() noexcept
+            : static_pool_resource(nullptr)
+        {
+        }
+
+        //! \param upstream The memory_resource to use as an upstream memory
+        //!                 provider
+        explicit static_pool_resource(memory_resource* upstream) noexcept
+            : m_upstream{upstream ? *upstream : *get_default_resource()}
+        {
+            const std::size_t sizes[] = {SizeClasses...};
+            for(std::size_t i = 0; i < class_count; ++i)
+            {
+                size_class& c = m_classes[i];
+                c.size = sizes[i];
+                c.align = std::min<std::size_t>(sizes[i] & (~sizes[i] + 1),
+                        detail::max_pool_block_align);
+                c.chunk_blocks = std::max<std::size_t>(
+                        1, chunk_size / sizes[i]);
+            }
+        }
+
+        static_pool_resource(const static_pool_resource&) = delete;
+
+        //! \sa release()
+        ~static_pool_resource()
+        {
+            release();
+        }
+
+        static_pool_resource& operator=(const static_pool_resource&) = delete;
+
+        //! Frees all memory allocated via this object, even if that memory
+        //! has not been deallocated.
+        void release()
+        {
+            m_chunks.release(m_upstream);
+            m_oversized.release(m_upstream);
+            for(size_class& c : m_classes)
+            {
+                c.free_list = nullptr;
+                c.next = nullptr;
+                c.end = nullptr;
+            }
+        }
+
+        //! Access the upstream memory resource used by this instance
+        memory_resource* upstream_resource() const
+        {
+            return &m_upstream;
+        }
+
+        //! \returns The size class serving requests of bytes, or
+        //!          class_count if they are too large for any
+        static std::size_t which_class(std::size_t bytes) noexcept
+        {
+            return bytes <= max_block_size
+                ? lookup::value[(bytes + granule - 1) / granule]
+                : std::size_t(class_count);
+        }
+
+      protected:
+        friend struct detail::resource_access;
+
+        void* do_allocate(std::size_t bytes, std::size_t align) override
+        {
+            if(size_class* c = class_for(bytes, align))
+            {
+                return c->allocate(m_chunks, m_upstream);
+            }
+            return m_oversized.extend(bytes, m_upstream, align);
+        }
+
+        allocation_result<void*> do_allocate_at_least(
+                std::size_t bytes, std::size_t align) override
+        {
+            if(size_class* c = class_for(bytes, align))
+            {
+                return {c->allocate(m_chunks, m_upstream), c->size};
+            }
+            return {m_oversized.extend(bytes, m_upstream, align), bytes};
+        }
+
+        void do_deallocate(void* ptr, std::size_t bytes,
+                std::size_t align) override
+        {
+            if(size_class* c = class_for(bytes, align))
+            {
+                return c->deallocate(ptr);
+            }
+            m_oversized.deallocate(ptr, bytes, m_upstream);
+        }
+
+        bool do_is_equal(const memory_resource& other) const override
+        {
+            return this == &other;
+        }
+
+      private:
+        using lookup = detail::size_class_table<classes, granule,
+              typename detail::make_index_list<
+                  max_block_size / granule + 1>::type>;
+
+        struct free_block
+        {
+            free_block* next;
+        };
+
+        struct size_class
+        {
+            void* allocate(detail::memblocks& chunks,
+                    memory_resource& upstream)
+            {
+                if(free_block* block = free_list)
+                {
+                    free_list = block->next;
+                    return block;
+                }
+                if(next == end)
+                {
+                    extend(chunks, upstream);
+                }
+                void* block = next;
+                next += size;
+                return block;
+            }
+
+            void deallocate(void* ptr) noexcept
+            {
+                free_list = ::new (ptr) free_block{free_list};
+            }
+
+            PMR_COLD void extend(detail::memblocks& chunks,
+                    memory_resource& upstream)
+            {
+                std::size_t bytes = size * chunk_blocks;
+                next = static_cast<char*>(chunks.extend(bytes, upstream,
+                            detail::max_pool_block_align));
+                end = next + bytes;
+            }
+
+            free_block* free_list = nullptr;
+            char* next = nullptr; // uncarved remainder of the newest chunk
+            char* end = nullptr;
+            std::size_t size = 0;
+            std::size_t align = 0;
+            std::size_t chunk_blocks = 0;
+        };
+
+        // nullptr if the request is not served from a pool
+        size_class* class_for(std::size_t bytes, std::size_t align) noexcept
+        {
+            for(std::size_t index = which_class(bytes); index < class_count;
+                    ++index)
+            {
+                if(align <= m_classes[index].align)
+                {
+                    return &m_classes[index];
+                }
+            }
+            return nullptr;
+        }
+
+        memory_resource& m_upstream;
+        size_class m_classes[class_count];
+        detail::memblocks m_chunks;
+        detail::memblocks m_oversized;
+    };
+}
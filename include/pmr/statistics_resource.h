@@ -0,0 +1,159 @@
+#pragma once
+
+#include "pmr/memory_resource.h"
+#include "pmr/detail/config.h"
+#include "pmr/detail/pool.h"
+#include "pmr/detail/thread_slots.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pmr
+{
+    //! A memory_resource that forwards to an upstream resource and counts
+    //! what passes through: bytes in use and their peak, allocations by
+    //! size and by alignment, deallocations and failed allocations.
+    //!
+    //! Each thread counts into a shard of its own that no other thread
+    //! writes, so counters are updated with plain loads and stores rather
+    //! than locked instructions and a call costs a few nanoseconds on top
+    //! of the upstream call. Shards live as long as the resource, keeping
+    //! the counts of threads that have exited. Bytes in use are folded
+    //! into a shared total once a shard has moved fold_bytes. An
+    //! allocation reaching a new peak raises it using the shared total and
+    //! its own shard's bytes, so the peak is exact for a single thread and
+    //! otherwise may miss up to fold_bytes for every other shard. Instances
+    //! are threadsafe if the upstream resource is.
+    class statistics_resource : public memory_resource
+    {
+      public:
+        //! Enumerators so that they need no definition in header-only
+        //! builds
+        enum : std::size_t
+        {
+            //! Size bucket i counts allocations of (2^(i-1), 2^i] bytes;
+            //! the last bucket also counts all larger allocations
+            size_buckets = 24,
+
+            //! Alignment bucket i counts allocations aligned to 2^i; the
+            //! last bucket also counts all larger alignments
+            align_buckets = 16,
+
+            //! The net bytes a shard may allocate or free before they are
+            //! added to the shared total
+            fold_bytes = 16 * 1024
+        };
+
+        //! A snapshot of the counters. Taken while other threads allocate,
+        //! the values are each accurate but not mutually consistent.
+        struct statistics
+        {
+            std::uint64_t allocations;
+            std::uint64_t deallocations;
+            std::uint64_t failed_allocations;
+            std::int64_t bytes_in_use;
+            std::int64_t peak_bytes_in_use;
+            std::array<std::uint64_t, size_buckets> sizes;
+            std::array<std::uint64_t, align_buckets> alignments;
+
+            //! The number of threads that have called into the instance
+            std::size_t threads;
+        };
+
+        //! Instantiate counting calls forwarded to upstream, or to
+        //! get_default_resource() if that is nullptr
+        explicit statistics_resource(memory_resource* upstream = nullptr);
+
+        statistics_resource(const statistics_resource&) = delete;
+        statistics_resource& operator=(const statistics_resource&) = delete;
+
+        //! Sum the counters of all threads
+        statistics stats() const noexcept;
+
+        //! \returns The size bucket counting allocations of bytes
+        static std::size_t size_bucket(std::size_t bytes) noexcept;
+
+        //! \returns The alignment bucket counting allocations aligned to
+        //!          align, a power of two
+        static std::size_t align_bucket(std::size_t align) noexcept;
+
+        memory_resource* upstream_resource() const;
+
+      protected:
+        friend struct detail::resource_access;
+
+        void* do_allocate(std::size_t bytes, std::size_t align) override;
+        void do_deallocate(void* ptr, std::size_t bytes,
+                std::size_t align) override;
+        bool do_is_equal(const memory_resource& other) const override;
+
+      private:
+        //! Written only by its thread; atomic so stats() may read it
+        struct shard
+        {
+            std::atomic<std::uint64_t> sizes[size_buckets];
+            std::atomic<std::uint64_t> alignments[align_buckets];
+            std::atomic<std::uint64_t> deallocations;
+            std::atomic<std::uint64_t> failures;
+            std::atomic<std::int64_t> pending; // not yet in m_in_use
+            char pad[detail::cache_line_size];
+        };
+
+        shard& local_shard();
+        PMR_COLD shard& register_shard();
+        void add_bytes(shard& s, std::int64_t bytes) noexcept;
+
+        memory_resource& m_upstream;
+        std::uint64_t m_id;
+        mutable std::mutex m_shards_lock;
+        std::vector<std::unique_ptr<shard>> m_shards;
+        detail::shard_map m_shards_by_thread;
+        std::atomic<std::int64_t> m_in_use;
+        std::atomic<std::int64_t> m_peak;
+    };
+
+
+    inline std::size_t
+    statistics_resource::size_bucket(std::size_t bytes) noexcept
+    {
+        if(bytes <= 1)
+        {
+            return 0;
+        }
+#       if defined(__GNUC__)
+        constexpr int digits = 8 * sizeof(unsigned long long);
+        std::size_t bucket = digits - __builtin_clzll(bytes - 1);
+#       else
+        std::size_t bucket = 0;
+        for(std::size_t limit = 1; limit < bytes; limit <<= 1)
+        {
+            ++bucket;
+        }
+#       endif
+        return std::min<std::size_t>(bucket, size_buckets - 1);
+    }
+
+
+    inline std::size_t
+    statistics_resource::align_bucket(std::size_t align) noexcept
+    {
+#       if defined(__GNUC__)
+        std::size_t bucket = __builtin_ctzll(align);
+#       else
+        std::size_t bucket = 0;
+        for(; align > 1; align >>= 1)
+        {
+            ++bucket;
+        }
+#       endif
+        return std::min<std::size_t>(bucket, align_buckets - 1);
+    }
+}
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/statistics_resource.ipp"
+#endif
@@ -2,16 +2,30 @@
 
 #include "pmr/memory_resource.h"
 #include "pmr/pool_options.h"
+#include "pmr/pool_statistics.h"
+#include "pmr/detail/cache_aligned.h"
+#include "pmr/detail/pool.h"
 #include <cstdint>
+#include <mutex>
 
 namespace pmr
 {
+    namespace detail
+    {
+        struct thread_cache;
+    }
 
     //! A memory_resource backed by a series of memory pools, structured
     //! by size. This class is safe for use by an unbounded number of threads
     //! concurrently.
     //!
-    //! \sa pmr::synchronized_pool_resource
+    //! Each thread using an instance gets its own cache of free blocks for
+    //! every pool so that most allocations and deallocations take no lock.
+    //! Caches are refilled from and flushed to the shared pools in batches.
+    //! Thread caches and the shared state of each pool sit on cache lines
+    //! of their own.
+    //!
+    //! \sa pmr::unsynchronized_pool_resource
     class synchronized_pool_resource : public memory_resource
     {
       public:
@@ -44,7 +58,8 @@ namespace pmr
                 const synchronized_pool_resource&) = delete;
 
         //! Frees all memory allocated via this object, even if that memory
-        //! has not been deallocated.
+        //! has not been deallocated. Must not be called concurrently with
+        //! allocate or deallocate.
         void release();
 
         //! Access the upstream memory resource used by this instance
@@ -60,19 +75,58 @@ namespace pmr
         //! \returns The pool_options used to size the internal memory pools
         pool_options options() const;
 
+        //! Describe the memory held by this instance. Blocks cached by
+        //! threads count as free. Taken while other threads allocate, the
+        //! figures for each pool are approximate.
+        pool_resource_statistics stats() const;
+
       protected:
         void* do_allocate(std::size_t bytes, std::size_t align) override;
 
+        allocation_result<void*> do_allocate_at_least(
+                std::size_t bytes, std::size_t align) override;
+
         void do_deallocate(
                 void * ptr, std::size_t bytes, std::size_t align) override;
 
+        void do_allocate_bulk(void** out, std::size_t n, std::size_t bytes,
+                std::size_t align) override;
+
+        void do_deallocate_bulk(void* const* ptrs, std::size_t n,
+                std::size_t bytes, std::size_t align) override;
+
         bool do_is_equal(const memory_resource& other) const override;
 
       private:
+        struct central_pool;
+        friend struct detail::resource_access;
+        friend struct detail::thread_cache;
+
         void adjust_pool_options();
+        void init_pools();
+
+        // index of the pool serving the request; m_pool_count if too large
+        std::size_t which_pool(std::size_t bytes, std::size_t align) const;
+
+        detail::thread_cache* local_cache();
+        detail::thread_cache* register_cache();
+        void refill(detail::thread_cache& cache, std::size_t index);
+        void flush(detail::thread_cache& cache, std::size_t index,
+                std::size_t count);
+        void flush(detail::thread_cache& cache);
 
         pool_options m_opts;
         memory_resource* m_upstream;
-        //std::vector<pool> m_pools;
+        std::uint64_t m_id;
+        std::size_t m_pool_count;
+        detail::cache_aligned_array<central_pool> m_pools;
+        mutable std::mutex m_oversized_lock;
+        detail::memblocks m_oversized;
+        mutable std::mutex m_caches_lock;
+        detail::thread_cache* m_caches = nullptr;
     };
 }
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/synchronized_pool_resource.ipp"
+#endif
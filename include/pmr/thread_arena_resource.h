@@ -0,0 +1,107 @@
+#pragma once
+
+#include "pmr/memory_resource.h"
+#include "pmr/monotonic_buffer_resource.h"
+#include "pmr/detail/config.h"
+#include "pmr/detail/pool.h"
+#include "pmr/detail/thread_slots.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pmr
+{
+    //! A group of monotonic_buffer_resource arenas, one per thread, that
+    //! presents itself as a single memory_resource. Each thread allocates
+    //! from its own arena without locks or shared writes, and release()
+    //! frees the arenas of all threads together, which suits data built by
+    //! a parallel loop that dies as one batch.
+    //!
+    //! A thread's arena is created on its first allocation and kept until
+    //! the group is destroyed, even after the thread exits. Deallocations
+    //! are no-ops, so a block may be deallocated by any thread. The
+    //! upstream resource is called from many threads at once and so must
+    //! be threadsafe.
+    class thread_arena_resource : public memory_resource
+    {
+      public:
+        //! Create a group whose arenas use the result of
+        //! pmr::get_default_resource() as their upstream memory_resource
+        thread_arena_resource();
+
+        //! \param upstream the upstream memory_resource of every arena
+        explicit thread_arena_resource(memory_resource* upstream);
+
+        //! Create a group whose arenas request at least initial_size bytes
+        //! in their first upstream block
+        thread_arena_resource(std::size_t initial_size,
+                memory_resource* upstream);
+
+        thread_arena_resource(const thread_arena_resource&) = delete;
+
+        //! Calls release()
+        ~thread_arena_resource();
+
+        thread_arena_resource& operator=(
+                const thread_arena_resource&) = delete;
+
+        //! Release the arenas of all threads. Must not be called
+        //! concurrently with allocate.
+        void release();
+
+        //! \returns The number of threads that have allocated from this
+        //!          group
+        std::size_t arenas() const;
+
+        //! Get this instance's upstream memory_resource
+        memory_resource* upstream_resource() const;
+
+      protected:
+        friend struct detail::resource_access;
+
+        void* do_allocate(std::size_t bytes, std::size_t align) override;
+
+        allocation_result<void*> do_allocate_at_least(
+                std::size_t bytes, std::size_t align) override;
+
+        void do_deallocate(void*, std::size_t, std::size_t) override
+        {
+        }
+
+        void do_allocate_bulk(void** out, std::size_t n, std::size_t bytes,
+                std::size_t align) override;
+
+        bool do_is_equal(const memory_resource& other) const override;
+
+      private:
+        //! Used only by its thread; padded so that neighbouring arenas
+        //! never share a cache line
+        struct arena
+        {
+            arena(std::size_t initial_size, memory_resource* upstream)
+                : mbr{initial_size, upstream}
+            {
+            }
+
+            char front_pad[detail::cache_line_size];
+            monotonic_buffer_resource mbr;
+            char back_pad[detail::cache_line_size];
+        };
+
+        monotonic_buffer_resource& local_arena();
+        PMR_COLD monotonic_buffer_resource& register_arena();
+
+        memory_resource& m_upstream;
+        std::size_t m_initial_size;
+        std::uint64_t m_id;
+        mutable std::mutex m_arenas_lock;
+        std::vector<std::unique_ptr<arena>> m_arenas;
+        detail::shard_map m_arenas_by_thread;
+    };
+}
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/thread_arena_resource.ipp"
+#endif
@@ -11,7 +11,7 @@ namespace pmr
               typename Pred = std::equal_to<K>>
     using unordered_map =
         std::unordered_map<K, V, Hash, Pred,
-            polymorphic_allocator<std::pair<const K, V>>;
+            polymorphic_allocator<std::pair<const K, V>>>;
 
 
     template <typename K,
@@ -20,5 +20,5 @@ namespace pmr
               typename Pred = std::equal_to<K>>
     using unordered_multimap =
         std::unordered_multimap<K, V, Hash, Pred,
-            polymorphic_allocator<std::pair<const K, V>>;
+            polymorphic_allocator<std::pair<const K, V>>>;
 }
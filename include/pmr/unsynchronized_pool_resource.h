@@ -3,6 +3,7 @@
 #include "pmr/memory_resource.h"
 #include "pmr/polymorphic_allocator.h"
 #include "pmr/pool_options.h"
+#include "pmr/pool_statistics.h"
 #include "pmr/detail/pool.h"
 #include <cstdint>
 #include <vector>
@@ -62,19 +63,35 @@ namespace pmr
         //! \returns The pool_options used to size the internal memory pools
         pool_options options() const;
 
+        //! Describe the memory held by this instance
+        pool_resource_statistics stats() const;
+
       protected:
+        friend struct detail::resource_access;
+
         void* do_allocate(std::size_t bytes, std::size_t align) override;
 
+        allocation_result<void*> do_allocate_at_least(
+                std::size_t bytes, std::size_t align) override;
+
         void do_deallocate(
                 void * ptr, std::size_t bytes, std::size_t align) override;
 
+        void do_allocate_bulk(void** out, std::size_t n, std::size_t bytes,
+                std::size_t align) override;
+
+        void do_deallocate_bulk(void* const* ptrs, std::size_t n,
+                std::size_t bytes, std::size_t align) override;
+
         bool do_is_equal(const memory_resource& other) const override;
 
         void init_pools();
 
       private:
         void adjust_pool_options();
-        detail::pool& which_pool(std::size_t bytes, std::size_t align);
+
+        // nullptr if the request is too large to be served from a pool
+        detail::pool* which_pool(std::size_t bytes, std::size_t align);
 
         pool_options m_opts;
         memory_resource& m_upstream;
@@ -82,3 +99,7 @@ namespace pmr
         detail::memblocks m_oversized;
     };
 }
+
+#ifdef PMR_HEADER_ONLY
+#   include "pmr/impl/unsynchronized_pool_resource.ipp"
+#endif
@@ -0,0 +1 @@
+#include "pmr/impl/batch_stack.ipp"
@@ -0,0 +1 @@
+#include "pmr/impl/concurrent_monotonic_resource.ipp"
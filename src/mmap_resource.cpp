@@ -0,0 +1 @@
+#include "pmr/impl/mmap_resource.ipp"
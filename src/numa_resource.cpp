@@ -0,0 +1 @@
+#include "pmr/impl/numa_resource.ipp"
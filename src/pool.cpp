@@ -0,0 +1 @@
+#include "pmr/impl/pool.ipp"
@@ -0,0 +1 @@
+#include "pmr/impl/recording_resource.ipp"
@@ -0,0 +1 @@
+#include "pmr/impl/statistics_resource.ipp"
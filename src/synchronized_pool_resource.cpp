@@ -0,0 +1 @@
+#include "pmr/impl/synchronized_pool_resource.ipp"
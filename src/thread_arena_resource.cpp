@@ -0,0 +1 @@
+#include "pmr/impl/thread_arena_resource.ipp"
@@ -0,0 +1 @@
+#include "pmr/impl/unsynchronized_pool_resource.ipp"
@@ -0,0 +1,126 @@
+#include "pmr/concurrent_monotonic_resource.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const char* tags = "[pmr][concurrent_monotonic_resource]";
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "cmr alloc from upstream", tags)
+{
+    pmr::concurrent_monotonic_resource cmr;
+    CHECK(cmr.upstream_resource() == &tracked_memory);
+
+    void* a = cmr.allocate(24, 8);
+    void* b = cmr.allocate(24, 8);
+    CHECK(1 == tracked_memory.allocations.size());
+    CHECK(static_cast<char*>(b) - static_cast<char*>(a) == 24);
+    cmr.deallocate(a, 24, 8);
+
+    cmr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "cmr geometric growth", tags)
+{
+    pmr::concurrent_monotonic_resource cmr{4096};
+    for(int i = 0; i < 1000; ++i)
+    {
+        cmr.allocate(64);
+    }
+    REQUIRE(tracked_memory.allocations.size() >= 3);
+    CHECK(4096 == tracked_memory.allocations[0]);
+    CHECK(8192 == tracked_memory.allocations[1]);
+
+    cmr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+    cmr.allocate(64);
+    CHECK(4096 == tracked_memory.allocations.back());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "cmr large request keeps current block", tags)
+{
+    pmr::concurrent_monotonic_resource cmr;
+    char* a = static_cast<char*>(cmr.allocate(16, 8));
+    void* big = cmr.allocate(1 << 20);
+    CHECK((1 << 20) == tracked_memory.allocations.back());
+    CHECK(static_cast<void*>(a + 16) == cmr.allocate(16, 8));
+    cmr.deallocate(big, 1 << 20);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "cmr alignment", tags)
+{
+    pmr::concurrent_monotonic_resource cmr;
+    for(std::size_t align : {1, 2, 8, 16, 64, 4096})
+    {
+        for(std::size_t bytes : {1, 7, 24, 100, 5000})
+        {
+            void* ptr = cmr.allocate(bytes, align);
+            CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % align);
+            std::memset(ptr, 0xff, bytes);
+        }
+    }
+    CHECK_THROWS_AS(cmr.allocate(std::size_t(-1) - 8), std::bad_alloc);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "cmr many threads", tags)
+{
+    pmr::concurrent_monotonic_resource cmr;
+    const int nthreads = 8;
+    const int per_thread = 5000;
+    std::vector<std::vector<std::pair<char*, std::size_t>>> claims(nthreads);
+    std::vector<std::uintptr_t> misaligned(nthreads, 0);
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < nthreads; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for(int i = 0; i < per_thread; ++i)
+            {
+                std::size_t bytes = 1 + (i * 37 + t) % 300;
+                std::size_t align = std::size_t(1) << (i % 7);
+                char* ptr = static_cast<char*>(cmr.allocate(bytes, align));
+                misaligned[t] += reinterpret_cast<std::uintptr_t>(ptr) % align;
+                std::memset(ptr, t, bytes);
+                claims[t].emplace_back(ptr, bytes);
+            }
+        });
+    }
+    for(std::thread& t : threads)
+    {
+        t.join();
+    }
+
+    // no two allocations overlap and none was written by another thread
+    std::vector<std::pair<char*, std::size_t>> all;
+    for(int t = 0; t < nthreads; ++t)
+    {
+        CHECK(0 == misaligned[t]);
+        for(const auto& claim : claims[t])
+        {
+            CHECK(std::all_of(claim.first, claim.first + claim.second,
+                        [t](char c) { return c == static_cast<char>(t); }));
+        }
+        all.insert(all.end(), claims[t].begin(), claims[t].end());
+    }
+    std::sort(all.begin(), all.end());
+    for(std::size_t i = 1; i < all.size(); ++i)
+    {
+        CHECK(all[i - 1].first + all[i - 1].second <= all[i].first);
+    }
+
+    cmr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
@@ -0,0 +1,70 @@
+#include "pmr/deque.h"
+#include "pmr/forward_list.h"
+#include "pmr/list.h"
+#include "pmr/map.h"
+#include "pmr/regex.h"
+#include "pmr/set.h"
+#include "pmr/string.h"
+#include "pmr/unordered_map.h"
+#include "pmr/unordered_set.h"
+#include "pmr/vector.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+
+namespace
+{
+    const char* tags = "[pmr][containers]";
+
+    template <typename Container>
+    void check_uses_resource()
+    {
+        tracking_memory_resource tmr{pmr::new_delete_resource()};
+        {
+            Container c{&tmr};
+            c.insert(c.end(), typename Container::value_type{});
+            REQUIRE(c.get_allocator().resource() == &tmr);
+            REQUIRE_FALSE(tmr.allocations.empty());
+        }
+        REQUIRE(tmr.all_memory_deallocated());
+    }
+}
+
+
+TEST_CASE("container typedefs allocate from the supplied resource", tags)
+{
+    check_uses_resource<pmr::vector<int>>();
+    check_uses_resource<pmr::deque<int>>();
+    check_uses_resource<pmr::list<int>>();
+    check_uses_resource<pmr::set<int>>();
+    check_uses_resource<pmr::multiset<int>>();
+    check_uses_resource<pmr::map<int, int>>();
+    check_uses_resource<pmr::multimap<int, int>>();
+    check_uses_resource<pmr::unordered_set<int>>();
+    check_uses_resource<pmr::unordered_multiset<int>>();
+    check_uses_resource<pmr::unordered_map<int, int>>();
+    check_uses_resource<pmr::unordered_multimap<int, int>>();
+
+    tracking_memory_resource tmr{pmr::new_delete_resource()};
+    {
+        pmr::forward_list<int> fl{&tmr};
+        fl.push_front(1);
+        REQUIRE(fl.get_allocator().resource() == &tmr);
+        REQUIRE_FALSE(tmr.allocations.empty());
+
+        pmr::cmatch m{&tmr};
+        REQUIRE(m.get_allocator().resource() == &tmr);
+    }
+    REQUIRE(tmr.all_memory_deallocated());
+}
+
+
+TEST_CASE("nested containers share the outer resource", tags)
+{
+    tracking_memory_resource tmr{pmr::new_delete_resource()};
+    {
+        pmr::map<int, pmr::string> m{&tmr};
+        m.emplace(1, "a value that is long enough to be allocated");
+        REQUIRE(m.at(1).get_allocator().resource() == &tmr);
+    }
+    REQUIRE(tmr.all_memory_deallocated());
+}
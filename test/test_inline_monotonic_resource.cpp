@@ -0,0 +1,54 @@
+#include "pmr/inline_monotonic_resource.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <cstdint>
+
+namespace
+{
+    const char* tags = "[pmr][inline_monotonic_resource]";
+
+
+    bool within(const void* ptr, const void* obj, std::size_t size)
+    {
+        auto p = reinterpret_cast<std::uintptr_t>(ptr);
+        auto o = reinterpret_cast<std::uintptr_t>(obj);
+        return o <= p && p < o + size;
+    }
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "inline buffer used first", tags)
+{
+    pmr::inline_monotonic_resource<256> imr;
+    CHECK(imr.upstream_resource() == &tracked_memory);
+
+    for(int i = 0; i < 8; ++i)
+    {
+        void* ptr = imr.allocate(32);
+        CHECK(within(ptr, &imr, sizeof(imr)));
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % alignof(std::max_align_t));
+    }
+    CHECK(tracked_memory.allocations.empty());
+
+    void* overflow = imr.allocate(32);
+    CHECK_FALSE(within(overflow, &imr, sizeof(imr)));
+    CHECK(1 == tracked_memory.allocations.size());
+
+    imr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+    CHECK(within(imr.allocate(32), &imr, sizeof(imr)));
+}
+
+
+TEST_CASE("inline resource with explicit upstream", tags)
+{
+    tracking_memory_resource upstream{pmr::new_delete_resource()};
+    {
+        pmr::inline_monotonic_resource<64> imr{&upstream};
+        CHECK(imr.upstream_resource() == &upstream);
+        CHECK(64 == imr.inline_capacity());
+        imr.allocate(128);
+        CHECK(1 == upstream.allocations.size());
+    }
+    CHECK(upstream.all_memory_deallocated());
+}
@@ -1,7 +1,10 @@
 #include "pmr/memory_resource.h"
+#include "pmr/polymorphic_allocator.h"
 #include "tracking_memory_resource.h"
 #include <catch.hpp>
+#include <cstdint>
 #include <new>
+#include <thread>
 
 
 TEST_CASE("null resource", "[pmr]")
@@ -51,3 +54,75 @@ TEST_CASE("replace default resource", "[pmr]")
     pmr::set_default_resource(nullptr);
     CHECK(before == pmr::get_default_resource());
 }
+
+
+TEST_CASE("thread default resource", "[pmr]")
+{
+    tracking_memory_resource global_mr{pmr::new_delete_resource()};
+    tracking_memory_resource outer_mr{pmr::new_delete_resource()};
+    tracking_memory_resource inner_mr{pmr::new_delete_resource()};
+    pmr::memory_resource* before = pmr::set_default_resource(&global_mr);
+    {
+        pmr::scoped_default_resource outer{&outer_mr};
+        CHECK(&outer_mr == pmr::get_default_resource());
+        {
+            pmr::scoped_default_resource inner{&inner_mr};
+            pmr::polymorphic_allocator<int> alloc;
+            CHECK(&inner_mr == alloc.resource());
+        }
+        CHECK(&outer_mr == pmr::get_default_resource());
+
+        // other threads keep the global default
+        pmr::memory_resource* seen = nullptr;
+        std::thread t{[&] { seen = pmr::get_default_resource(); }};
+        t.join();
+        CHECK(&global_mr == seen);
+    }
+    CHECK(&global_mr == pmr::get_default_resource());
+
+    CHECK(nullptr == pmr::set_thread_default_resource(&inner_mr));
+    CHECK(&inner_mr == pmr::set_thread_default_resource(nullptr));
+    CHECK(&global_mr == pmr::get_default_resource());
+    pmr::set_default_resource(before);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "default bulk allocate loops", "[pmr]")
+{
+    void* ptrs[4];
+    tracked_memory.allocate_bulk(ptrs, 4, 24);
+    CHECK(4 == tracked_memory.allocations.size());
+    CHECK(ptrs[0] != ptrs[3]);
+
+    tracked_memory.deallocate_bulk(ptrs, 4, 24);
+    CHECK(4 == tracked_memory.deallocations.size());
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "default allocate_at_least is exact", "[pmr]")
+{
+    pmr::allocation_result<void*> result = tracked_memory.allocate_at_least(24);
+    CHECK(24 == result.count);
+    tracked_memory.deallocate(result.ptr, result.count);
+    CHECK(tracked_memory.all_memory_deallocated());
+
+    result = tracked_memory.allocate_at_least(0);
+    CHECK(nullptr == result.ptr);
+    CHECK(0 == result.count);
+}
+
+
+TEST_CASE("new delete resource over-aligned", "[pmr]")
+{
+    pmr::memory_resource* mr = pmr::new_delete_resource();
+    for(std::size_t align : {32, 64, 4096})
+    {
+        for(std::size_t bytes : {1, 64, 10000})
+        {
+            void* ptr = mr->allocate(bytes, align);
+            CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % align);
+            mr->deallocate(ptr, bytes, align);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#include "pmr/mmap_resource.h"
+#include "pmr/monotonic_buffer_resource.h"
+#include "pmr/unsynchronized_pool_resource.h"
+#include <catch.hpp>
+#include <cstdint>
+#include <cstring>
+
+#ifdef PMR_HAS_MMAP
+namespace
+{
+    const char* tags = "[pmr][mmap_resource]";
+}
+
+
+TEST_CASE("mmap allocate and write", tags)
+{
+    pmr::mmap_resource mr;
+    CHECK(pmr::mmap_resource::page_mode::normal == mr.mode());
+    CHECK(0 == (mr.page_size() & (mr.page_size() - 1)));
+
+    for(std::size_t bytes : {1, 4096, 100000})
+    {
+        char* ptr = static_cast<char*>(mr.allocate(bytes));
+        REQUIRE(ptr);
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % mr.page_size());
+        std::memset(ptr, 0x5a, bytes);
+        mr.deallocate(ptr, bytes);
+    }
+}
+
+
+TEST_CASE("mmap allocate_at_least reports whole pages", tags)
+{
+    pmr::mmap_resource mr;
+    pmr::allocation_result<void*> result = mr.allocate_at_least(10);
+    CHECK(mr.page_size() == result.count);
+    mr.deallocate(result.ptr, result.count);
+}
+
+
+TEST_CASE("mmap alignment beyond page size", tags)
+{
+    pmr::mmap_resource mr;
+    std::size_t align = 1024 * 1024;
+    void* ptr = mr.allocate(10, align);
+    CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % align);
+    mr.deallocate(ptr, 10, align);
+}
+
+
+TEST_CASE("mmap huge page modes", tags)
+{
+    using mode = pmr::mmap_resource::page_mode;
+    for(mode m : {mode::transparent_huge, mode::huge})
+    {
+        pmr::mmap_resource mr{m};
+        CHECK(0 == (mr.page_size() & (mr.page_size() - 1)));
+        CHECK(mr.page_size() > pmr::mmap_resource{}.page_size());
+
+        // falls back to ordinary pages if no huge pages are reserved
+        char* ptr = static_cast<char*>(mr.allocate(3 * 1024 * 1024));
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % mr.page_size());
+        ptr[0] = ptr[3 * 1024 * 1024 - 1] = 1;
+        mr.deallocate(ptr, 3 * 1024 * 1024);
+
+        pmr::allocation_result<void*> result = mr.allocate_at_least(10);
+        CHECK(mr.page_size() == result.count);
+        mr.deallocate(result.ptr, result.count);
+    }
+}
+
+
+TEST_CASE("mmap given huge page size", tags)
+{
+    using mode = pmr::mmap_resource::page_mode;
+    std::size_t huge = 4 * pmr::mmap_resource{mode::huge}.page_size();
+    for(mode m : {mode::transparent_huge, mode::huge})
+    {
+        pmr::mmap_resource mr{m, huge};
+        CHECK(huge == mr.page_size());
+        CHECK(mr != pmr::mmap_resource{m});
+
+        // no pages of this size are reserved, so huge falls back as well
+        pmr::allocation_result<void*> result = mr.allocate_at_least(100);
+        CHECK(huge == result.count);
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(result.ptr) % huge);
+        static_cast<char*>(result.ptr)[huge - 1] = 1;
+        mr.deallocate(result.ptr, result.count);
+    }
+
+    // normal pages ignore it
+    CHECK(pmr::mmap_resource{} ==
+            pmr::mmap_resource(mode::normal, huge));
+}
+
+
+TEST_CASE("mmap as upstream", tags)
+{
+    pmr::mmap_resource mr;
+    {
+        pmr::monotonic_buffer_resource mbr{&mr};
+        for(int i = 0; i < 1000; ++i)
+        {
+            std::memset(mbr.allocate(1000), 0, 1000);
+        }
+    }
+    {
+        pmr::unsynchronized_pool_resource upr{&mr};
+        for(int i = 0; i < 1000; ++i)
+        {
+            std::memset(upr.allocate(100), 0, 100);
+        }
+    }
+}
+
+
+TEST_CASE("mmap equality", tags)
+{
+    pmr::mmap_resource mr1;
+    pmr::mmap_resource mr2;
+    pmr::mmap_resource huge{pmr::mmap_resource::page_mode::huge};
+
+    CHECK(mr1 == mr2);
+    CHECK(mr1 != huge);
+}
+#endif
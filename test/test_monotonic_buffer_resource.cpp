@@ -2,8 +2,11 @@
 #include "pmr/memory_resource.h"
 #include "tracking_memory_resource.h"
 #include <catch.hpp>
+#include <cstdint>
 #include <limits>
 #include <new>
+#include <numeric>
+#include <vector>
 
 namespace
 {
@@ -134,3 +137,311 @@ TEST_CASE_METHOD(use_tracking_default, "multiple allocations no upstream", tags)
     }
     CHECK(tracked_memory.allocations.empty());
 }
+
+
+TEST_CASE_METHOD(use_tracking_default, "bulk allocate is one bump", tags)
+{
+    pmr::monotonic_buffer_resource mbr;
+    void* ptrs[100];
+    mbr.allocate_bulk(ptrs, 100, 10, 8);
+    CHECK(1 == tracked_memory.allocations.size());
+    for(std::size_t i = 1; i < 100; ++i)
+    {
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(ptrs[i]) % 8);
+        CHECK(static_cast<char*>(ptrs[i]) - static_cast<char*>(ptrs[i - 1]) == 16);
+    }
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "allocate_at_least takes small tail", tags)
+{
+    alignas(16) char buf[100];
+    pmr::monotonic_buffer_resource mbr{buf, sizeof(buf)};
+
+    pmr::allocation_result<void*> first = mbr.allocate_at_least(32, 1);
+    CHECK(32 == first.count);
+
+    // 68 bytes remain which can't hold another 40 byte request
+    pmr::allocation_result<void*> second = mbr.allocate_at_least(40, 1);
+    CHECK(68 == second.count);
+    CHECK(tracked_memory.allocations.empty());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "over-aligned allocations", tags)
+{
+    pmr::monotonic_buffer_resource mbr;
+    for(std::size_t align : {64, 4096, 64, 32})
+    {
+        void* ptr = mbr.allocate(10, align);
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % align);
+    }
+    mbr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "new block needs no alignment padding", tags)
+{
+    pmr::monotonic_buffer_resource mbr{1024};
+    mbr.allocate(1024, 64);
+    CHECK(1 == tracked_memory.allocations.size());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "release rewinds to initial buffer", tags)
+{
+    alignas(std::max_align_t) char buf[64];
+    pmr::monotonic_buffer_resource mbr{buf, sizeof(buf)};
+
+    CHECK(mbr.allocate(64) == buf);
+    mbr.allocate(128);
+    REQUIRE(1 == tracked_memory.allocations.size());
+
+    mbr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+    CHECK(mbr.allocate(64) == buf);
+    CHECK(1 == tracked_memory.allocations.size());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "release restarts geometric growth", tags)
+{
+    pmr::monotonic_buffer_resource mbr;
+    for(int i = 0; i < 4; ++i)
+    {
+        mbr.allocate(100);
+        mbr.allocate(tracked_memory.allocations.back() + 100);
+        mbr.release();
+    }
+    REQUIRE(8 == tracked_memory.allocations.size());
+    CHECK(tracked_memory.allocations[6] == tracked_memory.allocations[0]);
+    CHECK(tracked_memory.allocations[7] == tracked_memory.allocations[1]);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "reset keeps upstream blocks", tags)
+{
+    alignas(std::max_align_t) char buf[64];
+    pmr::monotonic_buffer_resource mbr{buf, sizeof(buf)};
+
+    for(int i = 0; i < 100; ++i)
+    {
+        mbr.allocate(48);
+    }
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+    REQUIRE(upstream_allocs > 1);
+
+    for(int round = 0; round < 3; ++round)
+    {
+        mbr.reset();
+        CHECK(mbr.allocate(48) == buf);
+        for(int i = 1; i < 100; ++i)
+        {
+            mbr.allocate(48);
+        }
+        CHECK(upstream_allocs == tracked_memory.allocations.size());
+        CHECK(tracked_memory.deallocations.empty());
+    }
+
+    // a larger request than any kept block still goes upstream
+    mbr.reset();
+    mbr.allocate(1 << 20);
+    CHECK(upstream_allocs + 1 == tracked_memory.allocations.size());
+
+    mbr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "reset without initial buffer", tags)
+{
+    pmr::monotonic_buffer_resource mbr;
+    void* first = mbr.allocate(16);
+    mbr.reset();
+    CHECK(mbr.allocate(16) == first);
+    CHECK(1 == tracked_memory.allocations.size());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "rollback to checkpoint", tags)
+{
+    alignas(std::max_align_t) char buf[64];
+    pmr::monotonic_buffer_resource mbr{buf, sizeof(buf)};
+
+    CHECK(mbr.allocate(16) == buf);
+    auto cp = mbr.mark();
+    void* next = mbr.allocate(16);
+    for(int i = 0; i < 100; ++i)
+    {
+        mbr.allocate(48);
+    }
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+    REQUIRE(upstream_allocs > 0);
+
+    mbr.rollback(cp);
+    CHECK(tracked_memory.deallocations.empty());
+    CHECK(mbr.allocate(16) == next);
+
+    // blocks acquired after the checkpoint are reused
+    for(int i = 0; i < 100; ++i)
+    {
+        mbr.allocate(48);
+    }
+    CHECK(upstream_allocs == tracked_memory.allocations.size());
+
+    mbr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "rollback and trim", tags)
+{
+    alignas(std::max_align_t) char buf[64];
+    pmr::monotonic_buffer_resource mbr{buf, sizeof(buf)};
+
+    // blocks held at the checkpoint, one of them spare
+    for(int i = 0; i < 20; ++i)
+    {
+        mbr.allocate(48);
+    }
+    auto spare = mbr.mark();
+    mbr.allocate(4096);
+    mbr.rollback(spare);
+    auto cp = mbr.mark();
+    pmr::monotonic_buffer_resource::statistics before = mbr.stats();
+    REQUIRE(before.upstream_blocks > 1);
+
+    for(int i = 0; i < 500; ++i)
+    {
+        mbr.allocate(48);
+    }
+    pmr::monotonic_buffer_resource::statistics after = mbr.stats();
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+    std::size_t upstream_frees = tracked_memory.deallocations.size();
+    REQUIRE(after.upstream_blocks > before.upstream_blocks + 1);
+
+    // upstream gets back exactly the blocks obtained since the checkpoint
+    mbr.rollback_and_trim(cp);
+    const std::vector<std::size_t>& frees = tracked_memory.deallocations;
+    std::size_t trimmed = frees.size() - upstream_frees;
+    CHECK(after.upstream_blocks - before.upstream_blocks == trimmed);
+    CHECK(after.bytes_reserved - before.bytes_reserved ==
+            std::accumulate(frees.begin() + upstream_frees, frees.end(),
+                std::size_t(0)));
+    CHECK(before.upstream_blocks == mbr.stats().upstream_blocks);
+    CHECK(before.bytes_reserved == mbr.stats().bytes_reserved);
+
+    // and hands out blocks of the same sizes again
+    for(int i = 0; i < 500; ++i)
+    {
+        mbr.allocate(48);
+    }
+    CHECK(upstream_allocs + trimmed == tracked_memory.allocations.size());
+    CHECK(after.bytes_reserved == mbr.stats().bytes_reserved);
+
+    mbr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "nested savepoints", tags)
+{
+    pmr::monotonic_buffer_resource mbr;
+    mbr.allocate(16);
+    void* outer_next = nullptr;
+    void* kept = nullptr;
+    {
+        pmr::monotonic_buffer_resource::savepoint outer{mbr};
+        outer_next = mbr.allocate(16);
+        {
+            pmr::monotonic_buffer_resource::savepoint inner{mbr};
+            mbr.allocate(4096);
+        }
+        kept = mbr.allocate(16);
+        {
+            pmr::monotonic_buffer_resource::savepoint inner{mbr};
+            mbr.allocate(16);
+            inner.commit();
+        }
+        CHECK(mbr.allocate(16) != kept);
+    }
+    CHECK(mbr.allocate(16) == outer_next);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upstream blocks have exact sizes", tags)
+{
+    pmr::monotonic_buffer_resource mbr{4096};
+    for(int i = 0; i < 64; ++i)
+    {
+        mbr.allocate(4096);
+    }
+
+    // powers of two stay powers of two; descriptor arrays are the only
+    // other upstream requests
+    std::size_t blocks = 0;
+    for(std::size_t size : tracked_memory.allocations)
+    {
+        if(0 == (size & (size - 1)))
+        {
+            CHECK(size >= 4096);
+            ++blocks;
+        }
+    }
+    CHECK(tracked_memory.allocations[0] == 4096);
+    CHECK(blocks > 4);
+
+    mbr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "block descriptors come from upstream", tags)
+{
+    pmr::monotonic_buffer_resource mbr{4096};
+    while(mbr.stats().upstream_blocks < 10)
+    {
+        mbr.allocate(4096);
+    }
+    CHECK(tracked_memory.allocations.size() > mbr.stats().upstream_blocks);
+
+    mbr.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "stats", tags)
+{
+    alignas(16) char buf[64];
+    pmr::monotonic_buffer_resource mbr{buf, sizeof(buf)};
+
+    mbr.allocate(1, 1);
+    mbr.allocate(8, 8);
+    pmr::monotonic_buffer_resource::statistics s = mbr.stats();
+    CHECK(9 == s.bytes_allocated);
+    CHECK(7 == s.bytes_padding);
+    CHECK(0 == s.bytes_reserved);
+    CHECK(0 == s.upstream_blocks);
+
+    auto cp = mbr.mark();
+    mbr.allocate(100);
+    mbr.allocate(1000);
+    s = mbr.stats();
+    CHECK(1109 == s.bytes_allocated);
+    CHECK(tracked_memory.allocations.size() == s.upstream_blocks);
+    CHECK(s.bytes_reserved >= 1100);
+
+    mbr.rollback(cp);
+    CHECK(9 == mbr.stats().bytes_allocated);
+    CHECK(7 == mbr.stats().bytes_padding);
+    CHECK(s.bytes_reserved == mbr.stats().bytes_reserved);
+
+    mbr.reset();
+    CHECK(0 == mbr.stats().bytes_allocated);
+    CHECK(s.upstream_blocks == mbr.stats().upstream_blocks);
+
+    mbr.release();
+    CHECK(0 == mbr.stats().bytes_reserved);
+    CHECK(0 == mbr.stats().upstream_blocks);
+}
@@ -0,0 +1,62 @@
+#include "pmr/numa_resource.h"
+#include "pmr/monotonic_buffer_resource.h"
+#include <catch.hpp>
+#include <cstdint>
+#include <cstring>
+
+#ifdef PMR_HAS_MMAP
+namespace
+{
+    const char* tags = "[pmr][numa_resource]";
+}
+
+
+TEST_CASE("numa topology", tags)
+{
+    CHECK(pmr::numa_resource::node_count() >= 1);
+    int node = pmr::numa_resource::current_node();
+    CHECK(node >= 0);
+    CHECK(static_cast<std::size_t>(node) < pmr::numa_resource::node_count());
+}
+
+
+TEST_CASE("numa allocate on node", tags)
+{
+    pmr::numa_resource local;
+    pmr::numa_resource node0{0};
+    CHECK(pmr::numa_resource::local_node == local.node());
+    CHECK(0 == node0.node());
+
+    for(pmr::memory_resource* mr : {static_cast<pmr::memory_resource*>(&local),
+            static_cast<pmr::memory_resource*>(&node0)})
+    {
+        char* ptr = static_cast<char*>(mr->allocate(100000, 4096));
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % 4096);
+        std::memset(ptr, 1, 100000);
+        mr->deallocate(ptr, 100000, 4096);
+    }
+}
+
+
+TEST_CASE("numa as upstream", tags)
+{
+    pmr::numa_resource mr;
+    pmr::monotonic_buffer_resource mbr{&mr};
+    for(int i = 0; i < 100; ++i)
+    {
+        std::memset(mbr.allocate(1000), 0, 1000);
+    }
+}
+
+
+TEST_CASE("numa equality", tags)
+{
+    pmr::numa_resource node0{0};
+    pmr::numa_resource local;
+    pmr::mmap_resource plain;
+
+    // memory from any of these can be returned through any other
+    CHECK(node0 == local);
+    CHECK(node0 == plain);
+}
+#endif
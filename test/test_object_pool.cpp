@@ -0,0 +1,174 @@
+#include "pmr/object_pool.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    const char* tags = "[pmr][object_pool]";
+
+
+    struct counted
+    {
+        explicit counted(int v, bool fail = false)
+            : value{v}
+        {
+            if(fail)
+            {
+                throw std::runtime_error("constructor failed");
+            }
+            ++alive;
+        }
+
+        ~counted()
+        {
+            --alive;
+        }
+
+        static int alive;
+        int value;
+        char payload[20];
+    };
+
+    int counted::alive = 0;
+
+
+    struct alignas(32) over_aligned
+    {
+        char c;
+    };
+}
+
+
+TEST_CASE("object_pool slot layout", tags)
+{
+    CHECK(sizeof(void*) == pmr::object_pool<char>::slot_size);
+    CHECK(24 == pmr::object_pool<counted>::slot_size);
+    CHECK(32 == pmr::object_pool<over_aligned>::slot_size);
+    CHECK(32 == pmr::object_pool<over_aligned>::slot_align);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "object_pool create and destroy", tags)
+{
+    {
+        pmr::object_pool<counted> pool;
+        REQUIRE(pool.upstream_resource() == &tracked_memory);
+
+        counted* a = pool.create(1);
+        counted* b = pool.create(2);
+        CHECK(1 == a->value);
+        CHECK(2 == b->value);
+        CHECK(2 == counted::alive);
+        CHECK(2 == pool.size());
+        CHECK(reinterpret_cast<char*>(b) - reinterpret_cast<char*>(a) == 24);
+
+        pool.destroy(a);
+        CHECK(1 == counted::alive);
+        CHECK(a == pool.create(3));
+        CHECK(1 == tracked_memory.allocations.size());
+
+        CHECK_THROWS_AS(pool.create(4, true), std::runtime_error);
+        CHECK(2 == pool.size());
+    }
+    CHECK(0 == counted::alive);
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "object_pool clear destroys live objects", tags)
+{
+    pmr::object_pool<counted> pool{16, nullptr};
+    std::vector<counted*> objs;
+    for(int i = 0; i < 100; ++i)
+    {
+        objs.push_back(pool.create(i));
+    }
+    for(int i = 0; i < 100; i += 3)
+    {
+        pool.destroy(objs[i]);
+    }
+    std::size_t chunks = tracked_memory.allocations.size();
+    REQUIRE(chunks > 1);
+
+    pool.clear();
+    CHECK(0 == counted::alive);
+    CHECK(0 == pool.size());
+
+    // chunks are kept and reused
+    std::set<counted*> again;
+    for(int i = 0; i < 100; ++i)
+    {
+        again.insert(pool.create(i));
+    }
+    CHECK(100 == again.size());
+    CHECK(chunks == tracked_memory.allocations.size());
+    CHECK(tracked_memory.deallocations.empty());
+
+    pool.release();
+    CHECK(0 == counted::alive);
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "object_pool clear after scattered destroys", tags)
+{
+    pmr::object_pool<counted> pool{8, nullptr};
+    std::vector<counted*> objs;
+    for(int i = 0; i < 200; ++i)
+    {
+        objs.push_back(pool.create(i));
+    }
+    // free slots end up on the freelist out of address order
+    for(int i = 0; i < 200; i += 7)
+    {
+        pool.destroy(objs[(i * 37) % 200]);
+        objs[(i * 37) % 200] = nullptr;
+    }
+    pool.create(-1);
+    int live = counted::alive;
+
+    CHECK(noexcept(pool.clear()));
+    pool.clear();
+    CHECK(0 == counted::alive);
+    CHECK(live > 150);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "object_pool stats", tags)
+{
+    pmr::object_pool<std::uint64_t> pool{64, nullptr};
+    pmr::pool_statistics s = pool.stats();
+    CHECK(8 == s.block_size);
+    CHECK(0 == s.chunks);
+
+    std::vector<std::uint64_t*> objs;
+    for(int i = 0; i < 100; ++i)
+    {
+        objs.push_back(pool.create(i));
+    }
+    pool.destroy(objs[0]);
+    s = pool.stats();
+    CHECK(99 == s.used_blocks);
+    CHECK(tracked_memory.allocations.size() == s.chunks);
+    CHECK(s.blocks >= 100);
+    CHECK(s.blocks == s.used_blocks + s.free_blocks);
+
+    pool.clear();
+    CHECK(0 == pool.stats().used_blocks);
+    CHECK(s.blocks == pool.stats().blocks);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "object_pool over-aligned type", tags)
+{
+    pmr::object_pool<over_aligned> pool;
+    for(int i = 0; i < 300; ++i)
+    {
+        over_aligned* obj = pool.create();
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(obj) % 32);
+    }
+}
@@ -1,6 +1,7 @@
 #include "pmr/polymorphic_allocator.h"
 #include "pmr/memory_resource.h"
 #include "pmr/monotonic_buffer_resource.h"
+#include "pmr/unsynchronized_pool_resource.h"
 #include "tracking_memory_resource.h"
 #include <catch.hpp>
 #include <memory>
@@ -167,7 +168,9 @@ TEST_CASE_METHOD(use_tracking_default, "list of allocator-aware", tags)
     std::size_t allocations = tmr.allocations.size();
     CHECK(allocations == 3);
 
-    list_t copy = l;
+    // copy construction selects the default resource via
+    // select_on_container_copy_construction so pass the allocator explicitly
+    list_t copy{l, l.get_allocator()};
 
     // string inside the list copy allocated from stackbuf
     CHECK(chars == copy.front());
@@ -182,3 +185,15 @@ TEST_CASE_METHOD(use_tracking_default, "list of allocator-aware", tags)
 }
 
 
+
+
+TEST_CASE_METHOD(use_tracking_default, "allocate_at_least counts objects", tags)
+{
+    pmr::unsynchronized_pool_resource upr;
+    pmr::polymorphic_allocator<std::uint32_t> alloc{&upr};
+
+    // three 4 byte objects come from the 16 byte pool which has room for 4
+    pmr::allocation_result<std::uint32_t*> result = alloc.allocate_at_least(3);
+    CHECK(4 == result.count);
+    alloc.deallocate(result.ptr, result.count);
+}
@@ -0,0 +1,151 @@
+#include "pmr/recording_resource.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace
+{
+    const char* tags = "[pmr][recording_resource]";
+    const char* path = "test_recording_resource.trace";
+}
+
+
+TEST_CASE("records allocations and deallocations", tags)
+{
+    tracking_memory_resource tmr{pmr::new_delete_resource()};
+    {
+        pmr::recording_resource rec{path, &tmr};
+        void* a = rec.allocate(24, 8);
+        void* b = rec.allocate(100, 64);
+        rec.deallocate(a, 24, 8);
+        rec.deallocate(b, 100, 64);
+        CHECK(4 == rec.events());
+        CHECK(2 == tmr.allocations.size());
+    }
+    CHECK(tmr.all_memory_deallocated());
+
+    std::vector<pmr::trace_event> events = pmr::read_trace(path);
+    REQUIRE(4 == events.size());
+
+    CHECK(pmr::trace_event::allocate == events[0].op);
+    CHECK(0 == events[0].id);
+    CHECK(24 == events[0].bytes);
+    CHECK(8 == events[0].align);
+
+    CHECK(pmr::trace_event::allocate == events[1].op);
+    CHECK(1 == events[1].id);
+    CHECK(100 == events[1].bytes);
+    CHECK(64 == events[1].align);
+
+    CHECK(pmr::trace_event::deallocate == events[2].op);
+    CHECK(0 == events[2].id);
+    CHECK(pmr::trace_event::deallocate == events[3].op);
+    CHECK(1 == events[3].id);
+
+    for(std::size_t i = 1; i < events.size(); ++i)
+    {
+        CHECK(events[i - 1].timestamp <= events[i].timestamp);
+        CHECK(0 == events[i].thread);
+    }
+    std::remove(path);
+}
+
+
+TEST_CASE("a reused address gets a new id", tags)
+{
+    {
+        pmr::recording_resource rec{path, pmr::new_delete_resource()};
+        for(int i = 0; i < 3; ++i)
+        {
+            rec.deallocate(rec.allocate(32), 32);
+        }
+    }
+    std::vector<pmr::trace_event> events = pmr::read_trace(path);
+    REQUIRE(6 == events.size());
+    CHECK(2 == events[4].id);
+    CHECK(2 == events[5].id);
+    std::remove(path);
+}
+
+
+TEST_CASE("threads are numbered in order of first use", tags)
+{
+    {
+        pmr::recording_resource rec{path, pmr::new_delete_resource()};
+        rec.deallocate(rec.allocate(16), 16);
+        std::thread t{[&] { rec.deallocate(rec.allocate(16), 16); }};
+        t.join();
+    }
+    std::vector<pmr::trace_event> events = pmr::read_trace(path);
+    REQUIRE(4 == events.size());
+    CHECK(0 == events[1].thread);
+    CHECK(1 == events[2].thread);
+    CHECK(1 == events[3].thread);
+    std::remove(path);
+}
+
+
+TEST_CASE("traces larger than the write buffer", tags)
+{
+    {
+        pmr::recording_resource rec{path, pmr::new_delete_resource()};
+        for(int i = 0; i < 10000; ++i)
+        {
+            rec.deallocate(rec.allocate(8), 8);
+        }
+        rec.flush();
+        CHECK(20000 == pmr::read_trace(path).size());
+    }
+    CHECK(20000 == pmr::read_trace(path).size());
+    std::remove(path);
+}
+
+
+TEST_CASE("bad trace files are rejected", tags)
+{
+    CHECK_THROWS_AS(pmr::read_trace("no/such/file.trace"), std::system_error);
+    CHECK_THROWS_AS(pmr::recording_resource("no/such/dir/file.trace"),
+            std::system_error);
+
+    std::FILE* f = std::fopen(path, "wb");
+    REQUIRE(f);
+    std::fputs("not a trace at all", f);
+    std::fclose(f);
+    CHECK_THROWS_AS(pmr::read_trace(path), std::runtime_error);
+    std::remove(path);
+}
+
+
+TEST_CASE("traces of another version are rejected", tags)
+{
+    {
+        pmr::recording_resource rec{path};
+        rec.deallocate(rec.allocate(8), 8);
+    }
+    pmr::trace_header header;
+    std::FILE* f = std::fopen(path, "r+b");
+    REQUIRE(f);
+    REQUIRE(1 == std::fread(&header, sizeof(header), 1, f));
+    std::uint32_t version = header.version;
+    header.version = 1;
+    std::rewind(f);
+    REQUIRE(1 == std::fwrite(&header, sizeof(header), 1, f));
+    std::fclose(f);
+
+    try
+    {
+        pmr::read_trace(path);
+        FAIL("version 1 trace accepted");
+    }
+    catch(const std::runtime_error& e)
+    {
+        std::string expected = "not a version " + std::to_string(version);
+        CHECK(std::strstr(e.what(), expected.c_str()));
+    }
+    std::remove(path);
+}
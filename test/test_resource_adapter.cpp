@@ -51,3 +51,26 @@ TEST_CASE("resource_adapter equality", "[pmr]")
     CHECK(resource1 == resource2);
     CHECK(resource1 != resource3);
 }
+
+
+TEST_CASE_METHOD(use_tracking_default, "adapter allocate_at_least", "[pmr]")
+{
+    pmr::resource_adapter<pmr::polymorphic_allocator<char>> resource;
+    pmr::allocation_result<void*> result = resource.allocate_at_least(20, 16);
+    CHECK(32 == result.count);
+    CHECK(32 == tracked_memory.allocations.back());
+    resource.deallocate(result.ptr, result.count, 16);
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "allocate over-aligned", "[pmr]")
+{
+    pmr::resource_adapter<std::allocator<char>> resource;
+    for(std::size_t align : {32, 64, 256, 4096})
+    {
+        void* mem = resource.allocate(100, align);
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(mem) % align);
+        resource.deallocate(mem, 100, align);
+    }
+}
@@ -0,0 +1,152 @@
+#include "pmr/resource_allocator.h"
+#include "pmr/monotonic_buffer_resource.h"
+#include "pmr/unsynchronized_pool_resource.h"
+#include "pmr/polymorphic_allocator.h"
+#include "pmr/static_pool_resource.h"
+#include "pmr/string.h"
+#include "pmr/thread_arena_resource.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    const char* tags = "[pmr][resource_allocator]";
+
+
+    // overrides are inaccessible to resource_access, so calls go through
+    // the virtual interface
+    class private_resource : public pmr::memory_resource
+    {
+      public:
+        std::size_t allocations = 0;
+
+      private:
+        void* do_allocate(std::size_t bytes, std::size_t align) override
+        {
+            ++allocations;
+            return pmr::new_delete_resource()->allocate(bytes, align);
+        }
+
+        void do_deallocate(void* ptr, std::size_t bytes,
+                std::size_t align) override
+        {
+            pmr::new_delete_resource()->deallocate(ptr, bytes, align);
+        }
+
+        bool do_is_equal(const memory_resource& other) const override
+        {
+            return this == &other;
+        }
+    };
+
+
+    // counts the calls that reach the resource through the vtable
+    template <typename Resource>
+    class virtual_counter : public Resource
+    {
+      public:
+        std::size_t virtual_allocations = 0;
+
+      protected:
+        void* do_allocate(std::size_t bytes, std::size_t align) override
+        {
+            ++virtual_allocations;
+            return Resource::do_allocate(bytes, align);
+        }
+    };
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "vector on monotonic resource", tags)
+{
+    alignas(std::max_align_t) char buf[1024];
+    pmr::monotonic_buffer_resource mbr{buf, sizeof(buf)};
+    using alloc_t = pmr::resource_allocator<int, pmr::monotonic_buffer_resource>;
+    {
+        std::vector<int, alloc_t> v{alloc_t{&mbr}};
+        for(int i = 0; i < 100; ++i)
+        {
+            v.push_back(i);
+        }
+        CHECK(v.get_allocator().resource() == &mbr);
+        auto data = reinterpret_cast<std::uintptr_t>(v.data());
+        auto start = reinterpret_cast<std::uintptr_t>(buf);
+        CHECK(data >= start);
+        CHECK(data < start + sizeof(buf));
+        CHECK(99 == v.back());
+    }
+    CHECK(tracked_memory.allocations.empty());
+}
+
+
+TEST_CASE("interoperates with polymorphic_allocator", tags)
+{
+    pmr::unsynchronized_pool_resource upr;
+    pmr::monotonic_buffer_resource mbr;
+    pmr::resource_allocator<int, pmr::unsynchronized_pool_resource> ra{&upr};
+    pmr::resource_allocator<char, pmr::unsynchronized_pool_resource> rebound{ra};
+    pmr::polymorphic_allocator<long> pa = ra;
+
+    CHECK(pa.resource() == &upr);
+    CHECK(ra == rebound);
+    CHECK(ra == pa);
+    CHECK(pa == ra);
+    CHECK(ra != pmr::polymorphic_allocator<int>{&mbr});
+
+    int* p = ra.allocate(4);
+    REQUIRE(p);
+    CHECK(0 == reinterpret_cast<std::uintptr_t>(p) % alignof(int));
+    pa.deallocate(reinterpret_cast<long*>(p), 2);
+}
+
+
+TEST_CASE("nested pmr containers share the resource", tags)
+{
+    pmr::monotonic_buffer_resource mbr;
+    using alloc_t = pmr::resource_allocator<pmr::string,
+          pmr::monotonic_buffer_resource>;
+    std::vector<pmr::string, alloc_t> v{alloc_t{&mbr}};
+    v.emplace_back("a string long enough to need an allocation");
+
+    CHECK(v.back().get_allocator().resource() == &mbr);
+}
+
+
+TEST_CASE("inaccessible overrides use the virtual call", tags)
+{
+    private_resource r;
+    pmr::resource_allocator<int, private_resource> ra{&r};
+    int* p = ra.allocate(1);
+    CHECK(1 == r.allocations);
+    ra.deallocate(p, 1);
+}
+
+
+TEST_CASE("thread_arena_resource is called directly", tags)
+{
+    virtual_counter<pmr::thread_arena_resource> tar;
+    pmr::resource_allocator<int, pmr::thread_arena_resource> ra{&tar};
+    int* p = ra.allocate(4);
+    CHECK(0 == tar.virtual_allocations);
+    ra.deallocate(p, 4);
+
+    tar.allocate(16);
+    CHECK(1 == tar.virtual_allocations);
+}
+
+
+TEST_CASE("static_pool_resource is called directly", tags)
+{
+    using pools = pmr::static_pool_resource<8, 16, 32>;
+    virtual_counter<pools> sp;
+    pmr::resource_allocator<int, pools> ra{&sp};
+    std::vector<int, pmr::resource_allocator<int, pools>> v{ra};
+    for(int i = 0; i < 8; ++i)
+    {
+        v.push_back(i);
+    }
+    CHECK(0 == sp.virtual_allocations);
+    CHECK(7 == v.back());
+}
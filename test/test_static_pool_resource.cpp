@@ -0,0 +1,129 @@
+#include "pmr/static_pool_resource.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace
+{
+    const char* tags = "[pmr][static_pool_resource]";
+
+    using small_pools = pmr::static_pool_resource<8, 24, 64, 200>;
+}
+
+
+TEST_CASE("spool size class lookup", tags)
+{
+    CHECK(4 == small_pools::class_count);
+    CHECK(200 == small_pools::max_block_size);
+
+    CHECK(0 == small_pools::which_class(1));
+    CHECK(0 == small_pools::which_class(8));
+    CHECK(1 == small_pools::which_class(9));
+    CHECK(1 == small_pools::which_class(24));
+    CHECK(2 == small_pools::which_class(25));
+    CHECK(2 == small_pools::which_class(64));
+    CHECK(3 == small_pools::which_class(65));
+    CHECK(3 == small_pools::which_class(200));
+    CHECK(4 == small_pools::which_class(201));
+    CHECK(4 == small_pools::which_class(1 << 20));
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spool reuses freed blocks", tags)
+{
+    {
+        small_pools sp;
+        REQUIRE(sp.upstream_resource() == &tracked_memory);
+
+        void* a = sp.allocate(20, 8);
+        void* b = sp.allocate(24, 8);
+        CHECK(static_cast<char*>(b) - static_cast<char*>(a) == 24);
+        CHECK(1 == tracked_memory.allocations.size());
+
+        sp.deallocate(a, 20, 8);
+        CHECK(a == sp.allocate(17, 8));
+
+        // other classes carve their own chunks
+        sp.allocate(100, 8);
+        CHECK(2 == tracked_memory.allocations.size());
+    }
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spool distinct blocks across chunks", tags)
+{
+    small_pools sp;
+    std::set<void*> ptrs;
+    for(int i = 0; i < 5000; ++i)
+    {
+        ptrs.insert(sp.allocate(64, 64));
+    }
+    CHECK(5000 == ptrs.size());
+    for(void* ptr : ptrs)
+    {
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % 64);
+    }
+    CHECK(tracked_memory.allocations.size() > 1);
+
+    sp.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spool oversized and over-aligned", tags)
+{
+    {
+        small_pools sp;
+        void* big = sp.allocate(1000);
+        CHECK(1000 == tracked_memory.allocations.back());
+
+        // 24 byte blocks are only 8 byte aligned, 64 byte blocks are
+        // aligned to 64
+        std::size_t upstream_allocs = tracked_memory.allocations.size();
+        void* aligned = sp.allocate(24, 16);
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(aligned) % 16);
+        sp.deallocate(aligned, 24, 16);
+        pmr::allocation_result<void*> r = sp.allocate_at_least(24, 16);
+        CHECK(aligned == r.ptr);
+        CHECK(64 == r.count);
+        sp.deallocate(r.ptr, r.count);
+        CHECK(aligned == sp.allocate(64, 64));
+
+        // no class above 200 bytes is aligned to 16
+        void* over = sp.allocate(100, 16);
+        CHECK(0 == reinterpret_cast<std::uintptr_t>(over) % 16);
+        CHECK(100 == tracked_memory.allocations.back());
+        CHECK(upstream_allocs + 2 == tracked_memory.allocations.size());
+
+        sp.deallocate(big, 1000);
+        sp.deallocate(over, 100, 16);
+        CHECK(2 == tracked_memory.deallocations.size());
+
+        // released with the resource
+        sp.allocate(5000);
+    }
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spool allocate_at_least", tags)
+{
+    small_pools sp;
+    pmr::allocation_result<void*> r = sp.allocate_at_least(30, 8);
+    CHECK(64 == r.count);
+    sp.deallocate(r.ptr, r.count, 8);
+    CHECK(r.ptr == sp.allocate(40, 8));
+}
+
+
+TEST_CASE("spool equality", tags)
+{
+    small_pools sp1;
+    small_pools sp2;
+
+    CHECK(sp1 == sp1);
+    CHECK(sp1 != sp2);
+}
@@ -0,0 +1,139 @@
+#include "pmr/statistics_resource.h"
+#include "pmr/monotonic_buffer_resource.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const char* tags = "[pmr][statistics_resource]";
+}
+
+
+TEST_CASE("size and alignment buckets", tags)
+{
+    using sr = pmr::statistics_resource;
+    CHECK(0 == sr::size_bucket(0));
+    CHECK(0 == sr::size_bucket(1));
+    CHECK(1 == sr::size_bucket(2));
+    CHECK(2 == sr::size_bucket(3));
+    CHECK(2 == sr::size_bucket(4));
+    CHECK(6 == sr::size_bucket(64));
+    CHECK(7 == sr::size_bucket(65));
+    CHECK(sr::size_buckets - 1 == sr::size_bucket(std::size_t(1) << 40));
+
+    CHECK(0 == sr::align_bucket(1));
+    CHECK(3 == sr::align_bucket(8));
+    CHECK(6 == sr::align_bucket(64));
+    CHECK(sr::align_buckets - 1 == sr::align_bucket(std::size_t(1) << 30));
+}
+
+
+TEST_CASE("counts forwarded calls", tags)
+{
+    tracking_memory_resource tmr{pmr::new_delete_resource()};
+    pmr::statistics_resource sr{&tmr};
+
+    void* a = sr.allocate(24, 8);
+    void* b = sr.allocate(100, 64);
+    void* c = sr.allocate(100, 16);
+
+    pmr::statistics_resource::statistics s = sr.stats();
+    CHECK(3 == s.allocations);
+    CHECK(0 == s.deallocations);
+    CHECK(224 == s.bytes_in_use);
+    CHECK(224 == s.peak_bytes_in_use);
+    CHECK(1 == s.sizes[sr.size_bucket(24)]);
+    CHECK(2 == s.sizes[sr.size_bucket(100)]);
+    CHECK(1 == s.alignments[3]);
+    CHECK(1 == s.alignments[4]);
+    CHECK(1 == s.alignments[6]);
+    CHECK(3 == tmr.allocations.size());
+
+    sr.deallocate(a, 24, 8);
+    sr.deallocate(b, 100, 64);
+    s = sr.stats();
+    CHECK(2 == s.deallocations);
+    CHECK(100 == s.bytes_in_use);
+    CHECK(224 == s.peak_bytes_in_use);
+
+    sr.deallocate(c, 100, 16);
+    CHECK(tmr.all_memory_deallocated());
+}
+
+
+TEST_CASE("peak survives folding", tags)
+{
+    pmr::statistics_resource sr{pmr::new_delete_resource()};
+    std::vector<void*> blocks;
+    for(int i = 0; i < 64; ++i)
+    {
+        blocks.push_back(sr.allocate(1024));
+    }
+    for(void* p : blocks)
+    {
+        sr.deallocate(p, 1024);
+    }
+    pmr::statistics_resource::statistics s = sr.stats();
+    CHECK(0 == s.bytes_in_use);
+    CHECK(64 * 1024 == s.peak_bytes_in_use);
+}
+
+
+TEST_CASE("counts failed allocations", tags)
+{
+    pmr::statistics_resource sr{pmr::null_memory_resource()};
+    CHECK_THROWS_AS(sr.allocate(8), std::bad_alloc);
+    pmr::statistics_resource::statistics s = sr.stats();
+    CHECK(1 == s.failed_allocations);
+    CHECK(0 == s.allocations);
+    CHECK(0 == s.bytes_in_use);
+}
+
+
+TEST_CASE("threads count into their own shards", tags)
+{
+    pmr::statistics_resource sr{pmr::new_delete_resource()};
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&] {
+            for(int i = 0; i < 10000; ++i)
+            {
+                sr.deallocate(sr.allocate(48), 48);
+            }
+        });
+    }
+    for(std::thread& t : threads)
+    {
+        t.join();
+    }
+    pmr::statistics_resource::statistics s = sr.stats();
+    CHECK(40000 == s.allocations);
+    CHECK(40000 == s.deallocations);
+    CHECK(40000 == s.sizes[sr.size_bucket(48)]);
+    CHECK(0 == s.bytes_in_use);
+}
+
+
+TEST_CASE("shard survives slot eviction", tags)
+{
+    // consecutive resources take consecutive ids, so the first and the
+    // last share a slot in every thread's table
+    pmr::statistics_resource sr[pmr::detail::shard_slots + 1];
+    pmr::statistics_resource& first = sr[0];
+    pmr::statistics_resource& last = sr[pmr::detail::shard_slots];
+    for(int i = 0; i < 1000; ++i)
+    {
+        first.deallocate(first.allocate(16), 16);
+        last.deallocate(last.allocate(16), 16);
+    }
+
+    pmr::statistics_resource::statistics s = first.stats();
+    CHECK(1 == s.threads);
+    CHECK(1000 == s.allocations);
+    CHECK(1000 == s.deallocations);
+    CHECK(1 == last.stats().threads);
+}
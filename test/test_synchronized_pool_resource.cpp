@@ -0,0 +1,315 @@
+#include "pmr/synchronized_pool_resource.h"
+#include "pmr/memory_resource.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const char* tags = "[pmr][synchronized_pool_resource]";
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr alloc from upstream", tags)
+{
+    {
+        pmr::synchronized_pool_resource spr;
+        REQUIRE(spr.upstream_resource() == &tracked_memory);
+
+        void* ptr = spr.allocate(24);
+        CHECK(tracked_memory.allocations.size());
+        spr.deallocate(ptr, 24);
+    }
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr distinct blocks", tags)
+{
+    pmr::synchronized_pool_resource spr;
+    std::set<void*> ptrs;
+    for(int i = 0; i < 1000; ++i)
+    {
+        void* ptr = spr.allocate(16);
+        std::memset(ptr, 0xff, 16);
+        ptrs.insert(ptr);
+    }
+    CHECK(1000 == ptrs.size());
+    for(void* ptr : ptrs)
+    {
+        spr.deallocate(ptr, 16);
+    }
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr alignment", tags)
+{
+    pmr::synchronized_pool_resource spr;
+    for(std::size_t align : {1, 2, 4, 8, 16})
+    {
+        for(std::size_t bytes : {1, 3, 8, 24, 100, 10000})
+        {
+            void* ptr = spr.allocate(bytes, align);
+            CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % align);
+            spr.deallocate(ptr, bytes, align);
+        }
+    }
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr oversized", tags)
+{
+    pmr::pool_options opts;
+    opts.largest_required_pool_block = 256;
+    pmr::synchronized_pool_resource spr{opts, nullptr};
+    CHECK(256 == spr.options().largest_required_pool_block);
+
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+    void* big = spr.allocate(1000);
+    REQUIRE(upstream_allocs + 1 == tracked_memory.allocations.size());
+    spr.deallocate(big, 1000);
+    CHECK(1 == tracked_memory.deallocations.size());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr many threads", tags)
+{
+    {
+        pmr::synchronized_pool_resource spr;
+        std::atomic<int> corrupted{0};
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 8; ++t)
+        {
+            threads.emplace_back([&spr, &corrupted, t] {
+                std::vector<char*> ptrs;
+                for(int i = 0; i < 2000; ++i)
+                {
+                    std::size_t bytes = 16 + (i % 200);
+                    char* ptr = static_cast<char*>(spr.allocate(bytes));
+                    std::memset(ptr, t, bytes);
+                    ptrs.push_back(ptr);
+                }
+                for(std::size_t i = 0; i < ptrs.size(); ++i)
+                {
+                    std::size_t bytes = 16 + (i % 200);
+                    if(t != ptrs[i][bytes - 1])
+                    {
+                        ++corrupted;
+                    }
+                    spr.deallocate(ptrs[i], bytes);
+                }
+            });
+        }
+        for(std::thread& t : threads)
+        {
+            t.join();
+        }
+        CHECK(0 == corrupted);
+    }
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr cross thread free", tags)
+{
+    pmr::synchronized_pool_resource spr;
+    std::vector<void*> ptrs;
+    std::thread producer{[&] {
+        for(int i = 0; i < 1000; ++i)
+        {
+            ptrs.push_back(spr.allocate(64));
+        }
+    }};
+    producer.join();
+
+    std::thread consumer{[&] {
+        for(void* ptr : ptrs)
+        {
+            spr.deallocate(ptr, 64);
+        }
+    }};
+    consumer.join();
+
+    // blocks flushed by exiting threads are reused
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+    std::set<void*> reused;
+    for(int i = 0; i < 1000; ++i)
+    {
+        reused.insert(spr.allocate(64));
+    }
+    CHECK(upstream_allocs == tracked_memory.allocations.size());
+    CHECK(1000 == reused.size());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr destroyed before thread exit", tags)
+{
+    std::unique_ptr<pmr::synchronized_pool_resource> spr{
+        new pmr::synchronized_pool_resource};
+    bool allocated = false;
+    bool destroyed = false;
+    std::mutex m;
+    std::condition_variable cv;
+
+    std::thread worker{[&] {
+        spr->deallocate(spr->allocate(32), 32);
+        std::unique_lock<std::mutex> lock{m};
+        allocated = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return destroyed; });
+    }};
+
+    {
+        std::unique_lock<std::mutex> lock{m};
+        cv.wait(lock, [&] { return allocated; });
+        spr.reset();
+        destroyed = true;
+        cv.notify_all();
+    }
+    worker.join();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE("spr equality", tags)
+{
+    pmr::synchronized_pool_resource spr1;
+    pmr::synchronized_pool_resource spr2;
+
+    CHECK(spr1 == spr1);
+    CHECK(spr1 != spr2);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr bulk allocate/deallocate", tags)
+{
+    pmr::synchronized_pool_resource spr;
+    for(std::size_t n : {3, 100})
+    {
+        std::vector<void*> ptrs(n);
+        spr.allocate_bulk(ptrs.data(), n, 48);
+        CHECK(n == std::set<void*>(begin(ptrs), end(ptrs)).size());
+        spr.deallocate_bulk(ptrs.data(), n, 48);
+
+        std::size_t upstream_allocs = tracked_memory.allocations.size();
+        std::vector<void*> again(n);
+        spr.allocate_bulk(again.data(), n, 48);
+        CHECK(upstream_allocs == tracked_memory.allocations.size());
+        spr.deallocate_bulk(again.data(), n, 48);
+    }
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr large bulk batch is shared", tags)
+{
+    pmr::synchronized_pool_resource spr;
+    std::vector<void*> ptrs(1000);
+    spr.allocate_bulk(ptrs.data(), ptrs.size(), 64);
+    spr.deallocate_bulk(ptrs.data(), ptrs.size(), 64);
+
+    // a new thread's cache takes only a magazine's worth of the batch,
+    // leaving the rest for another thread
+    void* first = nullptr;
+    std::atomic<int> stage{0};
+    std::thread taker{[&] {
+        first = spr.allocate(64);
+        stage = 1;
+        while(stage != 2)
+        {
+            std::this_thread::yield();
+        }
+    }};
+    while(stage != 1)
+    {
+        std::this_thread::yield();
+    }
+    std::vector<void*> theirs(900);
+    std::thread{[&] {
+        spr.allocate_bulk(theirs.data(), theirs.size(), 64);
+    }}.join();
+    stage = 2;
+    taker.join();
+    std::set<void*> freed(begin(ptrs), end(ptrs));
+    std::size_t reused = 0;
+    for(void* ptr : theirs)
+    {
+        reused += freed.count(ptr);
+    }
+    CHECK(theirs.size() == reused);
+    spr.deallocate_bulk(theirs.data(), theirs.size(), 64);
+    spr.deallocate(first, 64);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr allocate_at_least", tags)
+{
+    pmr::synchronized_pool_resource spr;
+    pmr::allocation_result<void*> pooled = spr.allocate_at_least(100);
+    CHECK(128 == pooled.count);
+    spr.deallocate(pooled.ptr, pooled.count);
+    CHECK(pooled.ptr == spr.allocate(100));
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr over-aligned", tags)
+{
+    {
+        pmr::synchronized_pool_resource spr;
+        for(std::size_t align : {32, 64, 128, 4096})
+        {
+            for(std::size_t bytes : {1, 64, 100, 5000})
+            {
+                void* ptr = spr.allocate(bytes, align);
+                CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % align);
+                spr.deallocate(ptr, bytes, align);
+            }
+        }
+    }
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "spr stats", tags)
+{
+    pmr::synchronized_pool_resource spr;
+    const std::size_t index = 1; // serves 32 byte blocks
+    REQUIRE(32 == spr.stats().pools[index].block_size);
+
+    std::vector<void*> ptrs;
+    std::thread producer{[&] {
+        for(int i = 0; i < 1000; ++i)
+        {
+            ptrs.push_back(spr.allocate(24));
+        }
+    }};
+    producer.join();
+
+    // blocks left in the exited thread's cache are free
+    pmr::pool_statistics s = spr.stats().pools[index];
+    CHECK(1000 == s.used_blocks);
+    CHECK(s.blocks == s.used_blocks + s.free_blocks);
+
+    for(std::size_t i = 0; i < 500; ++i)
+    {
+        spr.deallocate(ptrs[i], 24);
+    }
+    CHECK(500 == spr.stats().pools[index].used_blocks);
+
+    std::vector<void*> rest(ptrs.begin() + 500, ptrs.end());
+    spr.deallocate_bulk(rest.data(), rest.size(), 24);
+    s = spr.stats().pools[index];
+    CHECK(0 == s.used_blocks);
+    CHECK(s.blocks == s.free_blocks);
+
+    void* big = spr.allocate(1 << 20);
+    CHECK(1 == spr.stats().oversized_blocks);
+    spr.deallocate(big, 1 << 20);
+    CHECK(0 == spr.stats().oversized_blocks);
+}
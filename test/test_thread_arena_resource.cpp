@@ -0,0 +1,132 @@
+#include "pmr/thread_arena_resource.h"
+#include "pmr/statistics_resource.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const char* tags = "[pmr][thread_arena_resource]";
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "tar one arena per thread", tags)
+{
+    pmr::thread_arena_resource tar;
+    CHECK(tar.upstream_resource() == &tracked_memory);
+    CHECK(0 == tar.arenas());
+
+    char* a = static_cast<char*>(tar.allocate(16, 8));
+    CHECK(static_cast<void*>(a + 16) == tar.allocate(16, 8));
+    CHECK(1 == tar.arenas());
+    CHECK(1 == tracked_memory.allocations.size());
+
+    char* other = nullptr;
+    std::thread t{[&] { other = static_cast<char*>(tar.allocate(16, 8)); }};
+    t.join();
+    CHECK(2 == tar.arenas());
+    CHECK(2 == tracked_memory.allocations.size());
+
+    // any thread may deallocate, which does nothing
+    tar.deallocate(other, 16, 8);
+    CHECK(static_cast<void*>(a + 32) == tar.allocate(16, 8));
+
+    tar.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+    CHECK(2 == tar.arenas());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "tar many threads release together", tags)
+{
+    pmr::thread_arena_resource tar{1 << 12, &tracked_memory};
+    const int nthreads = 8;
+    std::vector<std::vector<char*>> ptrs(nthreads);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < nthreads; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for(int i = 0; i < 2000; ++i)
+            {
+                char* ptr = static_cast<char*>(tar.allocate(40));
+                std::memset(ptr, t, 40);
+                ptrs[t].push_back(ptr);
+            }
+        });
+    }
+    for(std::thread& t : threads)
+    {
+        t.join();
+    }
+    CHECK(nthreads == tar.arenas());
+
+    std::set<char*> distinct;
+    for(int t = 0; t < nthreads; ++t)
+    {
+        for(char* ptr : ptrs[t])
+        {
+            CHECK(static_cast<char>(t) == ptr[39]);
+            distinct.insert(ptr);
+        }
+    }
+    CHECK(nthreads * 2000 == distinct.size());
+
+    tar.release();
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "tar arena survives slot eviction", tags)
+{
+    pmr::thread_arena_resource tar;
+    char* first = static_cast<char*>(tar.allocate(16, 8));
+
+    // resources sharing the thread's slots push the group out of them
+    std::vector<std::unique_ptr<pmr::statistics_resource>> others;
+    for(int i = 0; i < 16; ++i)
+    {
+        others.emplace_back(new pmr::statistics_resource);
+        others.back()->deallocate(others.back()->allocate(8), 8);
+    }
+    CHECK(static_cast<void*>(first + 16) == tar.allocate(16, 8));
+    CHECK(1 == tar.arenas());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "tar groups sharing a slot", tags)
+{
+    // consecutive groups take consecutive ids, so the first and the last
+    // share a slot in every thread's table
+    pmr::thread_arena_resource tars[pmr::detail::shard_slots + 1];
+    pmr::thread_arena_resource& first = tars[0];
+    pmr::thread_arena_resource& last = tars[pmr::detail::shard_slots];
+    char* a = static_cast<char*>(first.allocate(16, 8));
+    char* b = static_cast<char*>(last.allocate(16, 8));
+    for(int i = 1; i < 8; ++i)
+    {
+        CHECK(static_cast<void*>(a + 16 * i) == first.allocate(16, 8));
+        CHECK(static_cast<void*>(b + 16 * i) == last.allocate(16, 8));
+    }
+    CHECK(1 == first.arenas());
+    CHECK(1 == last.arenas());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "tar bulk and allocate_at_least", tags)
+{
+    pmr::thread_arena_resource tar;
+    void* ptrs[10];
+    tar.allocate_bulk(ptrs, 10, 24, 8);
+    for(int i = 1; i < 10; ++i)
+    {
+        CHECK(static_cast<char*>(ptrs[i]) - static_cast<char*>(ptrs[i - 1])
+                == 24);
+    }
+    CHECK(tar.allocate_at_least(8).count >= 8);
+    CHECK(1 == tar.arenas());
+}
@@ -0,0 +1,324 @@
+#include "pmr/unsynchronized_pool_resource.h"
+#include "pmr/memory_resource.h"
+#include "tracking_memory_resource.h"
+#include <catch.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const char* tags = "[pmr][unsynchronized_pool_resource]";
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr alloc from upstream", tags)
+{
+    {
+        pmr::unsynchronized_pool_resource upr;
+        REQUIRE(upr.upstream_resource() == &tracked_memory);
+
+        std::size_t before = tracked_memory.allocations.size();
+        void* ptr = upr.allocate(24);
+        CHECK(before + 1 == tracked_memory.allocations.size());
+        upr.deallocate(ptr, 24);
+    }
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr reuses freed blocks", tags)
+{
+    pmr::unsynchronized_pool_resource upr;
+    void* ptr = upr.allocate(32);
+    upr.deallocate(ptr, 32);
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+
+    CHECK(ptr == upr.allocate(32));
+    CHECK(upstream_allocs == tracked_memory.allocations.size());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr same size class shares chunk", tags)
+{
+    pmr::unsynchronized_pool_resource upr;
+    std::set<void*> ptrs;
+    upr.allocate(17);
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+    for(int i = 0; i < 5; ++i)
+    {
+        ptrs.insert(upr.allocate(20 + i));
+    }
+    CHECK(5 == ptrs.size());
+    CHECK(upstream_allocs == tracked_memory.allocations.size());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr alignment", tags)
+{
+    pmr::unsynchronized_pool_resource upr;
+    for(std::size_t align : {1, 2, 4, 8, 16})
+    {
+        for(std::size_t bytes : {1, 3, 8, 24, 100})
+        {
+            std::uintptr_t ptrval = reinterpret_cast<std::uintptr_t>(
+                    upr.allocate(bytes, align));
+            CHECK(0 == ptrval % align);
+        }
+    }
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr oversized", tags)
+{
+    pmr::pool_options opts;
+    opts.largest_required_pool_block = 256;
+    pmr::unsynchronized_pool_resource upr{opts, nullptr};
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+
+    void* big1 = upr.allocate(1000);
+    void* big2 = upr.allocate(2000);
+    REQUIRE(upstream_allocs + 2 == tracked_memory.allocations.size());
+    CHECK(tracked_memory.allocations.back() >= 2000);
+
+    upr.deallocate(big1, 1000);
+    upr.deallocate(big2, 2000);
+    CHECK(2 == tracked_memory.deallocations.size());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr many oversized freed in any order", tags)
+{
+    pmr::pool_options opts;
+    opts.largest_required_pool_block = 256;
+    pmr::unsynchronized_pool_resource upr{opts, nullptr};
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+
+    std::vector<std::pair<void*, std::size_t>> blocks;
+    for(std::size_t i = 0; i < 1000; ++i)
+    {
+        std::size_t bytes = 1000 + i % 7;
+        blocks.emplace_back(upr.allocate(bytes), bytes);
+    }
+    // the descriptors of so many blocks are spilled to upstream as well
+    CHECK(upstream_allocs + 1000 < tracked_memory.allocations.size());
+
+    // first in first out, then every third of the rest from the back
+    for(std::size_t i = 0; i < 500; ++i)
+    {
+        upr.deallocate(blocks[i].first, blocks[i].second);
+    }
+    for(std::size_t i = blocks.size(); i > 500; --i)
+    {
+        if(i % 3 == 0)
+        {
+            upr.deallocate(blocks[i - 1].first, blocks[i - 1].second);
+            blocks[i - 1].first = nullptr;
+        }
+    }
+    CHECK(upr.stats().oversized_blocks == 1000 - 500 - 167);
+
+    for(std::size_t i = 500; i < blocks.size(); ++i)
+    {
+        if(blocks[i].first)
+        {
+            upr.deallocate(blocks[i].first, blocks[i].second);
+        }
+    }
+    CHECK(0 == upr.stats().oversized_blocks);
+
+    // including the descriptor arrays, once released
+    upr.release();
+    const std::vector<std::size_t>& allocs = tracked_memory.allocations;
+    CHECK(std::accumulate(allocs.begin() + upstream_allocs, allocs.end(),
+                std::size_t(0)) ==
+            std::accumulate(tracked_memory.deallocations.begin(),
+                tracked_memory.deallocations.end(), std::size_t(0)));
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr release", tags)
+{
+    pmr::unsynchronized_pool_resource upr;
+    for(std::size_t bytes = 1; bytes < 10000; bytes *= 3)
+    {
+        upr.allocate(bytes);
+    }
+    upr.release();
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+
+    // pools remain usable after release
+    void* ptr = upr.allocate(64);
+    CHECK(upstream_allocs + 1 == tracked_memory.allocations.size());
+    upr.deallocate(ptr, 64);
+}
+
+
+TEST_CASE("upr normalizes options", tags)
+{
+    pmr::unsynchronized_pool_resource dflt;
+    CHECK(dflt.options().max_blocks_per_chunk > 0);
+    CHECK(dflt.options().largest_required_pool_block > 0);
+
+    pmr::pool_options opts;
+    opts.max_blocks_per_chunk = 10;
+    opts.largest_required_pool_block = 100;
+    pmr::unsynchronized_pool_resource upr{opts, nullptr};
+    CHECK(10 == upr.options().max_blocks_per_chunk);
+    CHECK(128 == upr.options().largest_required_pool_block);
+}
+
+
+TEST_CASE("upr equality", tags)
+{
+    pmr::unsynchronized_pool_resource upr1;
+    pmr::unsynchronized_pool_resource upr2;
+
+    CHECK(upr1 == upr1);
+    CHECK(upr1 != upr2);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr geometric chunk growth", tags)
+{
+    pmr::pool_options opts;
+    opts.max_blocks_per_chunk = 64;
+    pmr::unsynchronized_pool_resource upr{opts, nullptr};
+    std::size_t first = tracked_memory.allocations.size();
+
+    for(int i = 0; i < 1000; ++i)
+    {
+        upr.allocate(64);
+    }
+
+    // chunks of 64 byte blocks are powers of two
+    std::vector<std::size_t> chunks;
+    for(std::size_t i = first; i < tracked_memory.allocations.size(); ++i)
+    {
+        std::size_t size = tracked_memory.allocations[i];
+        if(0 == (size & (size - 1)))
+        {
+            chunks.push_back(size);
+        }
+    }
+    REQUIRE(chunks.size() > 2);
+
+    // chunks double until they hold max_blocks_per_chunk blocks
+    std::size_t cap = chunks.back();
+    CHECK(cap >= 64 * 64);
+    CHECK(cap < 2 * 64 * 64);
+    for(std::size_t i = 1; i < chunks.size(); ++i)
+    {
+        CHECK((chunks[i] == cap || chunks[i] > 1.5 * chunks[i - 1]));
+    }
+    CHECK(chunks.front() < cap / 4);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr bulk allocate/deallocate", tags)
+{
+    pmr::unsynchronized_pool_resource upr;
+    void* ptrs[100];
+    upr.allocate_bulk(ptrs, 100, 48);
+    CHECK(100 == std::set<void*>(ptrs, ptrs + 100).size());
+    upr.deallocate_bulk(ptrs, 100, 48);
+
+    // the whole batch is back on the freelist
+    std::size_t upstream_allocs = tracked_memory.allocations.size();
+    void* again[100];
+    upr.allocate_bulk(again, 100, 48);
+    CHECK(upstream_allocs == tracked_memory.allocations.size());
+    CHECK(std::set<void*>(ptrs, ptrs + 100) == std::set<void*>(again, again + 100));
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr allocate_at_least", tags)
+{
+    pmr::pool_options opts;
+    opts.largest_required_pool_block = 256;
+    pmr::unsynchronized_pool_resource upr{opts, nullptr};
+
+    pmr::allocation_result<void*> pooled = upr.allocate_at_least(40);
+    CHECK(64 == pooled.count);
+    upr.deallocate(pooled.ptr, pooled.count);
+    CHECK(pooled.ptr == upr.allocate(40));
+
+    pmr::allocation_result<void*> big = upr.allocate_at_least(1000);
+    CHECK(1000 == big.count);
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr over-aligned", tags)
+{
+    {
+        pmr::unsynchronized_pool_resource upr;
+        std::vector<std::pair<void*, std::size_t>> ptrs;
+        for(std::size_t align : {32, 64, 128, 4096})
+        {
+            for(std::size_t bytes : {1, 64, 100, 5000})
+            {
+                void* ptr = upr.allocate(bytes, align);
+                CHECK(0 == reinterpret_cast<std::uintptr_t>(ptr) % align);
+                ptrs.emplace_back(ptr, bytes);
+            }
+            for(auto& p : ptrs)
+            {
+                upr.deallocate(p.first, p.second, align);
+            }
+            ptrs.clear();
+        }
+    }
+    CHECK(tracked_memory.all_memory_deallocated());
+}
+
+
+TEST_CASE_METHOD(use_tracking_default, "upr stats", tags)
+{
+    pmr::unsynchronized_pool_resource upr;
+    pmr::pool_resource_statistics s = upr.stats();
+    REQUIRE(upr.options().largest_required_pool_block
+            == s.pools.back().block_size);
+    for(const pmr::pool_statistics& p : s.pools)
+    {
+        CHECK(0 == p.chunks);
+        CHECK(0 == p.used_blocks);
+    }
+
+    std::vector<void*> ptrs;
+    for(int i = 0; i < 10; ++i)
+    {
+        ptrs.push_back(upr.allocate(24));
+    }
+    void* big = upr.allocate(1 << 20);
+    upr.deallocate(ptrs.back(), 24);
+    ptrs.pop_back();
+
+    s = upr.stats();
+    auto p = std::find_if(begin(s.pools), end(s.pools),
+            [](const pmr::pool_statistics& p) { return 0 != p.chunks; });
+    REQUIRE(p != end(s.pools));
+    std::size_t index = p - begin(s.pools);
+    CHECK(32 == p->block_size);
+    CHECK(9 == p->used_blocks);
+    CHECK(p->blocks >= 10);
+    CHECK(p->blocks == p->used_blocks + p->free_blocks);
+    CHECK(1 == s.oversized_blocks);
+    CHECK((1 << 20) == s.oversized_bytes);
+
+    upr.deallocate(big, 1 << 20);
+    for(void* ptr : ptrs)
+    {
+        upr.deallocate(ptr, 24);
+    }
+    s = upr.stats();
+    CHECK(0 == s.oversized_blocks);
+    for(const pmr::pool_statistics& p : s.pools)
+    {
+        CHECK(0 == p.used_blocks);
+    }
+    upr.release();
+    CHECK(0 == upr.stats().pools[index].chunks);
+}
@@ -2,6 +2,8 @@
 
 #include "pmr/memory_resource.h"
 #include <algorithm>
+#include <mutex>
+#include <numeric>
 #include <vector>
 #include <ostream>
 
@@ -18,14 +20,20 @@ class tracking_memory_resource : public pmr::memory_resource
 
     void* do_allocate(std::size_t bytes, std::size_t align) override
     {
-        allocations.push_back(bytes);
+        {
+            std::lock_guard<std::mutex> guard{m_lock};
+            allocations.push_back(bytes);
+        }
         return m_delegate->allocate(bytes, align);
     }
 
 
     void do_deallocate(void* ptr, std::size_t bytes, std::size_t align) override
     {
-        deallocations.push_back(bytes);
+        {
+            std::lock_guard<std::mutex> guard{m_lock};
+            deallocations.push_back(bytes);
+        }
         m_delegate->deallocate(ptr, bytes, align);
     }
 
@@ -43,6 +51,7 @@ class tracking_memory_resource : public pmr::memory_resource
 
   private:
     pmr::memory_resource* m_delegate;
+    std::mutex m_lock; // lets pool resources call upstream from many threads
 };
 
 
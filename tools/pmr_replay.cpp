@@ -0,0 +1,276 @@
+// Replays an allocation trace written by pmr::recording_resource against
+// the library's resources and reports, for each, the replay time, the peak
+// RSS growth and the fragmentation: how much more memory the resource held
+// from upstream at its peak than the trace ever had live.
+//
+//     pmr-replay TRACE [--max-blocks-per-chunk=N]
+//                      [--largest-required-pool-block=N] [RESOURCE...]
+//
+// Each resource is replayed in a child process so that one does not see
+// the memory another left behind. Events are replayed in recorded order
+// on a single thread.
+
+#include "pmr/memory_resource.h"
+#include "pmr/monotonic_buffer_resource.h"
+#include "pmr/pool_options.h"
+#include "pmr/recording_resource.h"
+#include "pmr/synchronized_pool_resource.h"
+#include "pmr/unsynchronized_pool_resource.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    const char* resource_names[] = {
+        "new_delete_resource",
+        "monotonic_buffer_resource",
+        "unsynchronized_pool_resource",
+        "synchronized_pool_resource",
+    };
+
+
+    //! Forwards to new_delete_resource() and keeps track of the most bytes
+    //! that were allocated through it at once
+    class counting_resource : public pmr::memory_resource
+    {
+      public:
+        std::size_t peak() const
+        {
+            return m_peak;
+        }
+
+      protected:
+        void* do_allocate(std::size_t bytes, std::size_t align) override
+        {
+            void* ptr = pmr::new_delete_resource()->allocate(bytes, align);
+            m_current += bytes;
+            m_peak = std::max(m_peak, m_current);
+            return ptr;
+        }
+
+        void do_deallocate(void* ptr, std::size_t bytes,
+                std::size_t align) override
+        {
+            pmr::new_delete_resource()->deallocate(ptr, bytes, align);
+            m_current -= bytes;
+        }
+
+        bool do_is_equal(const memory_resource& other) const override
+        {
+            return this == &other;
+        }
+
+      private:
+        std::size_t m_current = 0;
+        std::size_t m_peak = 0;
+    };
+
+
+    struct trace
+    {
+        std::vector<pmr::trace_event> events;
+        std::vector<std::size_t> allocations; // index into events by id
+        std::size_t peak_live = 0;
+    };
+
+
+    trace load(const char* path)
+    {
+        trace t;
+        t.events = pmr::read_trace(path);
+        std::size_t live = 0;
+        for(std::size_t i = 0; i < t.events.size(); ++i)
+        {
+            const pmr::trace_event& e = t.events[i];
+            if(pmr::trace_event::allocate == e.op)
+            {
+                if(t.allocations.size() <= e.id)
+                {
+                    t.allocations.resize(e.id + 1, t.events.size());
+                }
+                t.allocations[e.id] = i;
+                live += e.bytes;
+                t.peak_live = std::max(t.peak_live, live);
+            }
+            else if(pmr::trace_event::unknown_id != e.id)
+            {
+                live -= e.bytes;
+            }
+        }
+        return t;
+    }
+
+
+    std::unique_ptr<pmr::memory_resource> make(const std::string& name,
+            const pmr::pool_options& opts, pmr::memory_resource* upstream)
+    {
+        std::unique_ptr<pmr::memory_resource> mr;
+        if("monotonic_buffer_resource" == name)
+        {
+            mr.reset(new pmr::monotonic_buffer_resource{upstream});
+        }
+        else if("unsynchronized_pool_resource" == name)
+        {
+            mr.reset(new pmr::unsynchronized_pool_resource{opts, upstream});
+        }
+        else if("synchronized_pool_resource" == name)
+        {
+            mr.reset(new pmr::synchronized_pool_resource{opts, upstream});
+        }
+        return mr;
+    }
+
+
+    long peak_rss_kb()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+
+    void replay(const trace& t, const std::string& name,
+            const pmr::pool_options& opts)
+    {
+        counting_resource upstream;
+        std::unique_ptr<pmr::memory_resource> owned =
+            make(name, opts, &upstream);
+        pmr::memory_resource& mr = owned ? *owned : upstream;
+
+        std::vector<void*> ptrs(t.allocations.size(), nullptr);
+        long rss_before = peak_rss_kb();
+        auto start = std::chrono::steady_clock::now();
+        for(const pmr::trace_event& e : t.events)
+        {
+            if(pmr::trace_event::allocate == e.op)
+            {
+                ptrs[e.id] = mr.allocate(e.bytes, e.align);
+            }
+            else if(pmr::trace_event::unknown_id != e.id)
+            {
+                mr.deallocate(ptrs[e.id], e.bytes, e.align);
+                ptrs[e.id] = nullptr;
+            }
+        }
+        std::chrono::duration<double> secs =
+            std::chrono::steady_clock::now() - start;
+        long rss_growth = peak_rss_kb() - rss_before;
+
+        // blocks the trace never freed
+        for(std::size_t id = 0; id < ptrs.size(); ++id)
+        {
+            if(ptrs[id])
+            {
+                const pmr::trace_event& e = t.events[t.allocations[id]];
+                mr.deallocate(ptrs[id], e.bytes, e.align);
+            }
+        }
+
+        std::size_t peak_upstream = upstream.peak();
+        double fragmentation = peak_upstream
+            ? 1.0 - double(t.peak_live) / double(peak_upstream) : 0.0;
+        std::printf("%s,%zu,%.6f,%.2f,%zu,%zu,%.4f,%ld\n", name.c_str(),
+                t.events.size(), secs.count(),
+                t.events.empty() ? 0.0 : secs.count() * 1e9 / t.events.size(),
+                t.peak_live, peak_upstream, fragmentation, rss_growth);
+        std::fflush(stdout);
+    }
+
+
+    bool option(const char* arg, const char* name, std::size_t& value)
+    {
+        std::size_t len = std::strlen(name);
+        if(0 != std::strncmp(arg, name, len) || '=' != arg[len])
+        {
+            return false;
+        }
+        value = std::strtoull(arg + len + 1, nullptr, 10);
+        return true;
+    }
+
+
+    int usage()
+    {
+        std::fprintf(stderr, "usage: pmr-replay TRACE "
+                "[--max-blocks-per-chunk=N] "
+                "[--largest-required-pool-block=N] [RESOURCE...]\n");
+        return 2;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        return usage();
+    }
+
+    pmr::pool_options opts;
+    std::vector<std::string> names;
+    for(int i = 2; i < argc; ++i)
+    {
+        if(option(argv[i], "--max-blocks-per-chunk",
+                    opts.max_blocks_per_chunk)
+                || option(argv[i], "--largest-required-pool-block",
+                    opts.largest_required_pool_block))
+        {
+            continue;
+        }
+        auto known = std::find(std::begin(resource_names),
+                std::end(resource_names), std::string{argv[i]});
+        if(known == std::end(resource_names))
+        {
+            std::fprintf(stderr, "unknown resource %s\n", argv[i]);
+            return usage();
+        }
+        names.push_back(argv[i]);
+    }
+    if(names.empty())
+    {
+        names.assign(std::begin(resource_names), std::end(resource_names));
+    }
+
+    trace t;
+    try
+    {
+        t = load(argv[1]);
+    }
+    catch(const std::exception& e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    std::printf("resource,events,seconds,ns_per_event,peak_live_bytes,"
+            "peak_upstream_bytes,fragmentation,rss_growth_kb\n");
+    std::fflush(stdout);
+    int status = 0;
+    for(const std::string& name : names)
+    {
+        pid_t child = fork();
+        if(0 == child)
+        {
+            replay(t, name, opts);
+            std::_Exit(0);
+        }
+        int child_status = 0;
+        if(child < 0 || child != waitpid(child, &child_status, 0)
+                || !WIFEXITED(child_status) || 0 != WEXITSTATUS(child_status))
+        {
+            std::fprintf(stderr, "replay against %s failed\n", name.c_str());
+            status = 1;
+        }
+    }
+    return status;
+}